@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic System Functions for CH32V003                                        * v1.4 *
+// Basic System Functions for CH32V003                                        * v1.5 *
 // ===================================================================================
 //
 // This file must be included!!! The system configuration and the system clock are 
@@ -43,6 +43,10 @@
 // DLY_us(n)                delay n microseconds
 // DLY_ms(n)                delay n milliseconds
 //
+// TIME_cycles()            get 64-bit number of system ticks since start
+// TIME_micros64()          get 64-bit number of microseconds since start
+// TIME_update()            keep 64-bit extension alive (call at least every 2^31 ticks)
+//
 // RST_now()                conduct software reset
 // RST_clearFlags()         clear all reset flags
 // RST_wasLowPower()        check if last reset was caused by low power
@@ -199,6 +203,17 @@ void MCO_init(void);                                    // init clock output to
 #define DLY_ms(n)         DLY_ticks((n) * DLY_MS_TIME)  // delay n milliseconds
 void DLY_ticks(uint32_t n);                             // delay n system ticks
 
+// ===================================================================================
+// Timestamp Functions
+// ===================================================================================
+// The 32-bit SYSTICK counter is extended to 64 bits in software without disabling
+// interrupts, so the functions can be called from any context. The extension must
+// be read at least once every 2^31 ticks (89s @ 24MHz), e.g. with TIME_update() in
+// the main loop or a periodic timer. F_CPU must be a multiple of 1MHz for micros.
+uint64_t TIME_cycles(void);                             // 64-bit system ticks
+uint64_t TIME_micros64(void);                           // 64-bit microseconds
+#define TIME_update()     ((void)TIME_cycles())         // update 64-bit extension
+
 // ===================================================================================
 // Reset Functions
 // ===================================================================================
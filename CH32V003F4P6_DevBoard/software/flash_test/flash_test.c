@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   FLASH Demo for CH32V003
-// Version:   v1.1
+// Version:   v1.4
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -11,6 +11,17 @@
 // Description:
 // ------------
 // FLASH, Option Bytes (OB) and Electronic Signature (ESIG) demo.
+// On the first start, the time needed to write 1KB to the end of the code flash is
+// measured with halfword programming (FLASH_write) and with fast page programming
+// (FLASH_writeBlock). The firmware itself is used as test data, it must therefore
+// be smaller than 14KB. The results are kept in the key/value store, which also
+// serves as the flag that the benchmark has been done, so the benchmark pages are
+// not erased and rewritten on every power-up.
+// A boot counter is kept in the log-structured key/value store (include/kvstore.h),
+// which uses the pages behind the benchmark area. It survives resets and reflashing
+// as long as the firmware stays small enough.
+// Set DEBUG_TRACE in include/debug_serial.h to 1 to send compact binary trace records
+// instead of text and decode them on the PC with 'make trace'.
 //
 // References:
 // -----------
@@ -31,23 +42,84 @@
 #include <system.h>                           // system functions
 #include <gpio.h>                             // GPIO functions
 #include <flash.h>                            // FLASH functions
+#include <kvstore.h>                          // key/value store functions
 #include <debug_serial.h>                     // serial DEBUG functions
 
 #define PIN_LED   PC0                         // define LED pin
 #define PIN_RST   PD7                         // define RST pin
 
+#define BENCH_PAGE  224                       // first page of benchmark area
+#define BENCH_LEN   1024                      // number of bytes to write
+
+#define KEY_BOOTS   0                         // key of boot counter
+#define KEY_BENCH   1                         // key of benchmark results
+
+// Benchmark results (stored in key/value store)
+typedef struct {
+  uint32_t slow;                              // halfword programming in us
+  uint32_t fast;                              // fast page programming in us
+} BENCH_t;
+
+// ===================================================================================
+// FLASH Write Benchmark
+// ===================================================================================
+void BENCH_run(BENCH_t* result) {
+  const uint16_t* src = (const uint16_t*)FLASH_CODE_BASE; // firmware as test data
+  uint32_t addr = FLASH_PAGE_BASE(BENCH_PAGE);
+  uint32_t start, slow, fast;
+  uint16_t i, errors = 0;
+
+  FLASH_unlock();                             // unlock flash
+
+  // Erase pages and write halfword by halfword
+  start = STK->CNT;
+  for(i = 0; i < BENCH_LEN / FLASH_PAGE_SIZE; i++) FLASH_PAGE_erase(BENCH_PAGE + i);
+  for(i = 0; i < BENCH_LEN / 2; i++) FLASH_write(addr + (i << 1), src[i]);
+  slow = STK->CNT - start;
+
+  // Erase pages and write with fast page programming
+  start = STK->CNT;
+  FLASH_writeBlock(BENCH_PAGE, (const uint32_t*)FLASH_CODE_BASE, BENCH_LEN);
+  fast = STK->CNT - start;
+
+  FLASH_lock();                               // lock flash
+
+  // Verify and return results
+  for(i = 0; i < BENCH_LEN / 2; i++) if(FLASH_read(addr + (i << 1)) != src[i]) errors++;
+  DEBUG_print("FLASH VERIFY ERRORS: ");
+  DEBUG_printD(errors);
+  DEBUG_newline();
+  result->slow = slow / DLY_US_TIME;
+  result->fast = fast / DLY_US_TIME;
+}
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
+  uint32_t boots = 0;
+  BENCH_t  bench;
+
   // Setup
   DEBUG_init();                               // init serial debug
 
+  // Count boots in key/value store
+  KV_init();                                  // build index of key/value store
+  KV_read(KEY_BOOTS, &boots, sizeof(boots));  // read boot counter (0 if not found)
+  boots++;
+  KV_write(KEY_BOOTS, &boots, sizeof(boots)); // store new value
+
   // Perform some option bytes manipulations
   FLASH_OB_erase();                           // erase prior to rewrite
   FLASH_OB_RESET2GPIO();                      // make reset pin anormal GPIO pin
   FLASH_OB_DATA_write(0xCAFE);                // write value to user data
 
+  // Compare flash write methods once (KV_delete(KEY_BENCH) to run it again)
+  if(!KV_read(KEY_BENCH, &bench, sizeof(bench))) {
+    BENCH_run(&bench);                        // (overwrites pages 224..239)
+    KV_write(KEY_BENCH, &bench, sizeof(bench)); // store results, benchmark is done
+  }
+
   // Write data to end of code flash area
   FLASH_unlock();                             // unlock flash
   FLASH_END_erase();                          // erase last code flash page (64 bytes)
@@ -79,6 +151,17 @@ int main(void) {
     DEBUG_printH(FLASH_END_read(2));
     DEBUG_newline();
 
+    DEBUG_print("BOOT COUNTER:        ");     // print boot counter from KV store
+    DEBUG_printD(boots);
+    DEBUG_newline();
+
+    DEBUG_print("WRITE 1KB HALFWORD:  ");     // print benchmark results from KV store
+    DEBUG_printD(bench.slow);
+    DEBUG_println(" us");
+    DEBUG_print("WRITE 1KB FASTPAGE:  ");
+    DEBUG_printD(bench.fast);
+    DEBUG_println(" us");
+
     DEBUG_print("FLASH CAPACITY:      ");     // print flash capacity
     DEBUG_printD(ESIG->ESIG_FLACAP);
     DEBUG_println(" KB");
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for CH32V003                                  * v1.2 *
+// Basic Serial Debug Functions for CH32V003                                  * v1.7 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -7,6 +7,22 @@
 
 #if DEBUG_ENABLE > 0
 
+#if (DEBUG_BUFFERED > 0) && (SYS_USE_VECTORS == 0)
+  #error DEBUG_BUFFERED needs SYS_USE_VECTORS set to 1 in system.h (DMA interrupt)
+#endif
+
+#if DEBUG_BUFFERED > 0
+#define DEBUG_MSTATUS_MIE 0x08                    // mstatus: machine interrupt enable
+#define DEBUG_IRQ_enabled() (__get_MSTATUS() & DEBUG_MSTATUS_MIE)
+
+// Circular TX buffer, drained by DMA channel 4 in the background
+char DEBUG_TX_buffer[DEBUG_BUF_SIZE];
+volatile uint16_t DEBUG_TX_hptr;                  // head pointer, written by DEBUG_write
+volatile uint16_t DEBUG_TX_tptr;                  // tail pointer, advanced by DMA interrupt
+volatile uint16_t DEBUG_TX_len;                   // length of running DMA transfer (0: idle)
+volatile uint32_t DEBUG_dropped;                  // number of dropped bytes
+#endif
+
 // Init debug interface (UART TX)
 void DEBUG_init(void) {
   RCC->APB2PCENR |= RCC_AFIOEN | RCC_IOPDEN | RCC_USART1EN;
@@ -14,17 +30,125 @@ void DEBUG_init(void) {
                                   |  ((uint32_t)0b1001<<(5<<2));
   USART1->BRR     = ((2 * F_CPU / DEBUG_BAUD) + 1) / 2;
   USART1->CTLR1   = USART_CTLR1_TE | USART_CTLR1_UE;
+
+  #if DEBUG_BUFFERED > 0
+  // Setup DMA channel 4 for USART1 TX
+  DEBUG_TX_hptr = 0;
+  DEBUG_TX_tptr = 0;
+  DEBUG_TX_len  = 0;
+  DEBUG_dropped = 0;
+  RCC->AHBPCENR |= RCC_DMA1EN;
+  USART1->CTLR3 |= USART_CTLR3_DMAT;
+  DMA1_Channel4->PADDR = (uint32_t)&USART1->DATAR;
+  DMA1_Channel4->CFGR  = DMA_CFGR1_MINC           // increment memory address
+                       | DMA_CFGR1_DIR            // memory to peripheral
+                       | DMA_CFGR1_TCIE;          // transfer complete interrupt enable
+  NVIC_EnableIRQ(DMA1_Channel4_IRQn);             // enable DMA channel 4 interrupt
+  #endif
+}
+
+#if DEBUG_BUFFERED > 0
+// Start DMA transfer of the next contiguous chunk in TX buffer (DMA must be idle)
+static void DEBUG_TX_start(void) {
+  uint16_t head = DEBUG_TX_hptr;
+  uint16_t tail = DEBUG_TX_tptr;
+  uint16_t len  = (head >= tail) ? (head - tail) : (DEBUG_BUF_SIZE - tail);
+  DEBUG_TX_len = len;
+  if(!len) return;
+  DMA1_Channel4->CFGR &= ~DMA_CFGR1_EN;
+  DMA1_Channel4->MADDR = (uint32_t)&DEBUG_TX_buffer[tail];
+  DMA1_Channel4->CNTR  = len;
+  DMA1_Channel4->CFGR |= DMA_CFGR1_EN;
+}
+
+// Release transmitted chunk and start next one
+static void DEBUG_TX_next(void) {
+  uint16_t tail = DEBUG_TX_tptr + DEBUG_TX_len;
+  if(tail >= DEBUG_BUF_SIZE) tail = 0;
+  DEBUG_TX_tptr = tail;
+  DMA1->INTFCR = DMA_CGIF4;                       // clear interrupt flags
+  DEBUG_TX_start();                               // chain next chunk (if any)
+}
+
+// DMA transfer complete interrupt service routine
+void DMA1_Channel4_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel4_IRQHandler(void) {
+  DEBUG_TX_next();
+}
+
+// Service DMA by polling if interrupts are disabled (e.g. in fault handler or ISR)
+static void DEBUG_TX_poll(void) {
+  if(!DEBUG_IRQ_enabled() && (DMA1->INTFR & DMA_TCIF4)) DEBUG_TX_next();
+}
+
+// Get number of free bytes in TX buffer
+uint16_t DEBUG_txFree(void) {
+  uint16_t head = DEBUG_TX_hptr;
+  uint16_t tail = DEBUG_TX_tptr;
+  return((tail > head) ? (tail - head - 1) : (DEBUG_BUF_SIZE - 1 - head + tail));
+}
+
+// Send buffer via UART (copy into TX buffer, drop or wait if TX buffer is full)
+void DEBUG_writeBuffer(const char* buf, uint16_t len) {
+  #if DEBUG_DROP > 0
+  if((DEBUG_txFree() < len) && DEBUG_IRQ_enabled()) {   // no space, IRQs enabled?
+    DEBUG_dropped += len;                         // drop whole message
+    return;
+  }
+  #endif
+  while(len) {
+    uint16_t head = DEBUG_TX_hptr;
+    uint16_t tail = DEBUG_TX_tptr;
+    uint16_t cnt  = (tail > head) ? (tail - head - 1)
+                                  : (DEBUG_BUF_SIZE - head - (tail == 0));
+    if(!cnt) {                                    // TX buffer is full:
+      DEBUG_TX_poll();                            // wait for DMA
+      continue;
+    }
+    if(cnt > len) cnt = len;                      // copy contiguous part only
+    len -= cnt;
+    while(cnt--) DEBUG_TX_buffer[head++] = *buf++;
+    if(head >= DEBUG_BUF_SIZE) head = 0;
+    DEBUG_TX_hptr = head;
+    if(!DEBUG_TX_len) DEBUG_TX_start();           // start DMA if idle
+  }
 }
 
 // Send byte via UART
 void DEBUG_write(const char c) {
-  while(!(USART1->STATR & USART_STATR_TC));
+  DEBUG_writeBuffer(&c, 1);
+}
+
+// Wait until all bytes in TX buffer are transmitted
+void DEBUG_flush(void) {
+  while(DEBUG_TX_len) DEBUG_TX_poll();            // wait for DMA to finish
+  while(!(USART1->STATR & USART_STATR_TC));       // wait for last byte to leave
+}
+
+#else
+// Send byte via UART
+void DEBUG_write(const char c) {
+  while(!(USART1->STATR & USART_STATR_TXE));
   USART1->DATAR = c;
 }
 
+// Send buffer via UART
+void DEBUG_writeBuffer(const char* buf, uint16_t len) {
+  while(len--) DEBUG_write(*buf++);
+}
+
+// Wait until last byte is transmitted
+void DEBUG_flush(void) {
+  while(!(USART1->STATR & USART_STATR_TC));
+}
+#endif
+
+#if DEBUG_TRACE == 0
 // Send string via UART
 void DEBUG_print(const char* str) {
-  while(*str) DEBUG_write(*str++);
+  const char* end = str;
+  while(*end) end++;
+  DEBUG_writeBuffer(str, end - str);
 }
 
 // Send string via UART with newline
@@ -33,48 +157,53 @@ void DEBUG_println(const char* str) {
   DEBUG_write('\n');
 }
 
-// For BCD conversion
-const uint32_t DIVIDER[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
-                            10000000, 100000000, 1000000000};
+// Divide by 10 using shifts and adds (no hardware divider/multiplier needed)
+static inline uint32_t DEBUG_div10(uint32_t n) {
+  uint32_t q = (n >> 1) + (n >> 2);
+  q += (q >> 4);
+  q += (q >> 8);
+  q += (q >> 16);
+  q >>= 3;
+  return q + ((n - (((q << 2) + q) << 1)) > 9);
+}
 
-// Print decimal value (BCD conversion by substraction method)
+// Print decimal value (BCD conversion by reciprocal division)
 void DEBUG_printD(uint32_t value) {
-  uint8_t digits   = 10;                          // print 10 digits
-  uint8_t leadflag = 0;                           // flag for leading spaces
-  while(digits--) {                               // for all digits digits
-    uint8_t digitval = 0;                         // start with digit value 0
-    uint32_t divider = DIVIDER[digits];           // read current divider
-    while(value >= divider) {                     // if current divider fits into the value
-      leadflag = 1;                               // end of leading spaces
-      digitval++;                                 // increase digit value
-      value -= divider;                           // decrease value by divider
-    }
-    if(!digits)  leadflag++;                      // least digit has to be printed
-    if(leadflag) DEBUG_write(digitval + '0');     // print the digit
-  }
+  char buf[10];                                   // max 10 digits
+  char* ptr = buf + sizeof(buf);                  // fill buffer from the end
+  do {                                            // for all digits
+    uint32_t q = DEBUG_div10(value);              // divide by 10
+    *--ptr = value - (((q << 2) + q) << 1) + '0'; // remainder is digit
+    value = q;                                    // continue with quotient
+  } while(value);                                 // until no digits left
+  DEBUG_writeBuffer(ptr, buf + sizeof(buf) - ptr); // send all digits at once
 }
 
-// Convert 4-bit byte nibble into hex character and print it via UART
-void DEBUG_printN(uint8_t nibble) {
-  DEBUG_write((nibble <= 9) ? ('0' + nibble) : ('A' - 10 + nibble));
+// Convert value into n hex characters and send them via UART
+static void DEBUG_printX(uint32_t value, uint8_t digits) {
+  char buf[8];
+  for(uint8_t i = digits; i; i--) {
+    uint8_t nibble = value & 0x0f;
+    buf[i - 1] = (nibble <= 9) ? ('0' + nibble) : ('A' - 10 + nibble);
+    value >>= 4;
+  }
+  DEBUG_writeBuffer(buf, digits);
 }
 
 // Convert 8-bit byte into hex characters and print it via UART
 void DEBUG_printB(uint8_t value) {
-  DEBUG_printN(value >> 4);
-  DEBUG_printN(value & 0x0f);
+  DEBUG_printX(value, 2);
 }
 
 // Convert 16-bit half-word into hex characters and print it via UART
 void DEBUG_printH(uint16_t value) {
-  DEBUG_printB(value >> 8);
-  DEBUG_printB(value);
+  DEBUG_printX(value, 4);
 }
 
 // Convert 32-bit word into hex characters and print it via UART
 void DEBUG_printW(uint32_t value) {
-  DEBUG_printH(value >> 16);
-  DEBUG_printH(value);
+  DEBUG_printX(value, 8);
 }
+#endif  // DEBUG_TRACE == 0
 
 #endif
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for CH32V003                                  * v1.2 *
+// Basic Serial Debug Functions for CH32V003                                  * v1.7 *
 // ===================================================================================
 //
 // Functions available:
@@ -8,6 +8,7 @@
 // DEBUG_setBaud(n)         Set BAUD rate
 //
 // DEBUG_write(c)           Send character
+// DEBUG_writeBuffer(p,n)   Send n bytes from buffer p (block-write sink for print.h)
 // DEBUG_print(s)           Send string
 // DEBUG_println(s)         Send string with newline
 // DEBUG_printS(s)          Send string (alias)
@@ -16,6 +17,21 @@
 // DEBUG_printH(n)          Send 16-bit half-word hex value as string
 // DEBUG_printB(n)          Send  8-bit byte hex value as string
 // DEBUG_newline()          Send newline
+// DEBUG_flush()            Wait until all bytes are transmitted (e.g. before reset/sleep)
+//
+// If DEBUG_BUFFERED is set, DEBUG_write() and DEBUG_writeBuffer() only copy the data
+// into a TX ring buffer which is sent in the background by DMA channel 4. When the
+// buffer is full, the data is either dropped (DEBUG_DROP = 1, counted in DEBUG_dropped)
+// or the functions wait for free space (DEBUG_DROP = 0). When interrupts are disabled
+// (e.g. in a fault handler), the DMA is serviced by polling and the functions always
+// wait, so call DEBUG_flush() there before halting or resetting.
+// SYS_USE_VECTORS in system.h must be set to 1, since the DMA interrupt is used (the
+// vector table costs about 160 bytes of flash; set DEBUG_BUFFERED to 0 if that hurts).
+// Do not use the DEBUG functions from both main loop and interrupts at the same time.
+//
+// If DEBUG_TRACE is set, the DEBUG_print functions send binary trace records instead
+// of text, which are decoded on the host (needs trace.h/trace.c, the ".trace" section
+// in the linker script and tools/tracedec.py). Strings must then be string literals.
 //
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -26,11 +42,15 @@ extern "C" {
 #endif
 
 #include <stdio.h>
-#include "ch32v003.h"
+#include "system.h"
 
 // DEBUG parameters
 #define DEBUG_ENABLE      1                 // enable serial DEBUG (0:no, 1:yes)
 #define DEBUG_BAUD        115200            // default UART baud rate
+#define DEBUG_BUFFERED    1                 // 1: send in background via DMA
+#define DEBUG_BUF_SIZE    128               // TX buffer size
+#define DEBUG_DROP        0                 // buffer full: 0: wait, 1: drop message
+#define DEBUG_TRACE       0                 // 1: send binary trace records (trace.h)
 
 // DEBUG macros
 #define DEBUG_setBAUD(n)  USART1->BRR = ((2*F_CPU/(n))+1)/2;  // set BAUD rate
@@ -40,15 +60,34 @@ extern "C" {
 #if DEBUG_ENABLE > 0
   void DEBUG_init(void);                    // init UART with default BAUD rate
   void DEBUG_write(const char c);           // send character via UART
+  void DEBUG_writeBuffer(const char* buf, uint16_t len); // send buffer via UART
+  void DEBUG_flush(void);                   // wait until all bytes are transmitted
+  #if DEBUG_TRACE > 0
+  #include "trace.h"
+  #define DEBUG_print(s)    TRACE(s)         // send string as trace record
+  #define DEBUG_println(s)  TRACE(s "\n")    // send string with newline as trace record
+  #define DEBUG_printD(n)   TRACE("%u", n)   // send decimal value as trace record
+  #define DEBUG_printW(n)   TRACE("%08X", n) // send hex word value as trace record
+  #define DEBUG_printH(n)   TRACE("%04X", n) // send hex half-word value as trace record
+  #define DEBUG_printB(n)   TRACE("%02X", n) // send hex byte value as trace record
+  #define DEBUG_newline()   TRACE("\n")      // send newline as trace record
+  #else
   void DEBUG_print(const char* str);        // send string via UART
   void DEBUG_println(const char* str);      // send string with newline via UART
   void DEBUG_printD(uint32_t value);        // send decimal value as string
   void DEBUG_printW(uint32_t value);        // send hex word value as string
   void DEBUG_printH(uint16_t value);        // send hex half-word value as string
   void DEBUG_printB(uint8_t value);         // send hex byte value as string
+  #endif
+  #if DEBUG_BUFFERED > 0
+  uint16_t DEBUG_txFree(void);              // get number of free bytes in TX buffer
+  extern volatile uint32_t DEBUG_dropped;   // number of dropped bytes
+  #endif
 #else
   #define DEBUG_init()
   #define DEBUG_write(x)
+  #define DEBUG_writeBuffer(x,y)
+  #define DEBUG_flush()
   #define DEBUG_print(x)
   #define DEBUG_println(x)
   #define DEBUG_printD(x)
@@ -57,7 +96,9 @@ extern "C" {
   #define DEBUG_printB(x)
 #endif
 
+#ifndef DEBUG_newline
 #define DEBUG_newline() DEBUG_write('\n')   // send newline
+#endif
 #define DEBUG_printS    DEBUG_print         // alias for print
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic FLASH Functions for CH32V003                                         * v1.1 *
+// Basic FLASH Functions for CH32V003                                         * v1.3 *
 // ===================================================================================
 //
 // Functions available:
@@ -11,6 +11,8 @@
 // FLASH_read(a)            Read 16-bit data from FLASH address (a)
 // FLASH_write(a, d)        Write 16-bit data (d) to FLASH address (a)
 // FLASH_PAGE_erase(p)      Erase CODE FLASH page (0..255, 64 bytes each)
+// FLASH_PAGE_write(p, d)   Write 16 words (64 bytes) from (d) to erased page (p) at once
+// FLASH_writeBlock(p,d,n)  Erase pages starting at (p) and write (n) bytes from (d)
 //
 // FLASH_END_erase()        Erase last page of CODE FLASH (64 bytes)
 // FLASH_END_read(a)        Read 16-bit data from CODE FLASH END address (a)
@@ -49,6 +51,11 @@
 //   FLASH_OB_protect(), FLASH_OB_unprotect(), FLASH_OB_RESET2GPIO() and 
 //   FLASH_OB_DEFAULT().
 // - FLASH areas must be erased before being overwritten.
+// - FLASH_PAGE_write(p, d) uses fast page programming: the 16 words are loaded into
+//   the page buffer and then programmed in one single operation. This is much faster
+//   than writing 32 halfwords with FLASH_write(a, d). FLASH_writeBlock(p, d, n) erases
+//   and fast-programs as many pages as needed for (n) bytes, the rest of the last
+//   page is filled with 0xFF. The data (d) must be word-aligned.
 // - The addresses (a) in FLASH_END_read(a) and FLASH_END_write(a, d) are counted
 //   from the end of the CODE FLASH area meaning these functions can be used to store
 //   user data without affecting the firmware code (if there's enough space left).
@@ -64,7 +71,9 @@ extern "C" {
 #include "ch32v003.h"
 
 void FLASH_write(uint32_t addr, uint16_t data);
-void FLASH_PAGE_erase(uint8_t page);
+void FLASH_PAGE_erase(uint16_t page);
+void FLASH_PAGE_write(uint16_t page, const uint32_t* data);
+void FLASH_writeBlock(uint16_t page, const uint32_t* data, uint16_t len);
 void FLASH_OB_write(uint32_t addr, uint8_t data);
 void FLASH_OB_protect(void);
 void FLASH_OB_unprotect(void);
@@ -78,6 +87,7 @@ void FLASH_OB_DATA_write(uint16_t data);
 #define FLASH_BOOT_BASE         0x1FFFF000
 #define FLASH_CODE_BASE         FLASH_BASE
 #define FLASH_PAGE_BASE(p)      (FLASH_BASE + ((uint16_t)(p) << 6))
+#define FLASH_PAGE_SIZE         64
 
 #define FLASH_read(a)           (*(__IO uint16_t *)(a))
 #define FLASH_END_erase()       FLASH_PAGE_erase(255)
@@ -0,0 +1,246 @@
+// ===================================================================================
+// Log-Structured Key/Value Store in CODE FLASH for CH32V003                  * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "kvstore.h"
+
+// Layout definitions
+#define KV_HEADER         4                               // page header size
+#define KV_RECORD(len)    (4 + (((len) + 1) & ~1))        // record size in bytes
+#define KV_NONE           0xFF                            // no page
+#define KV_ERASED         0xFFFF                          // erased halfword
+#define KV_PAGE_ADDR(p)   FLASH_PAGE_BASE(KV_FIRST_PAGE + (p))
+#define KV_read16(a)      (*(__IO uint16_t*)(a))
+#define KV_read8(a)       (*(__IO uint8_t*)(a))
+
+// All keys must fit into the pages which are not needed for compaction
+#if KV_KEYS * KV_RECORD(KV_MAX_LEN) > (KV_PAGES - 2) * (FLASH_PAGE_SIZE - KV_HEADER - KV_RECORD(KV_MAX_LEN) + 2)
+  #error Too many keys or values too long for KV_PAGES
+#endif
+
+// RAM index and state
+uint16_t KV_index[KV_KEYS];                               // record address - FLASH_BASE
+uint8_t  KV_head;                                         // page written to
+uint8_t  KV_wptr;                                         // write offset in head page
+uint16_t KV_seq;                                          // sequence number of head page
+
+// Update CRC16 (CCITT) with one byte
+static uint16_t KV_CRC_update(uint16_t crc, uint8_t data) {
+  uint8_t i;
+  crc ^= (uint16_t)data << 8;
+  for(i = 8; i; i--) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  return crc;
+}
+
+// Calculate CRC over record key, length and value (never returns KV_ERASED)
+static uint16_t KV_CRC(uint8_t key, uint8_t len, const uint8_t* data) {
+  uint16_t crc = KV_CRC_update(KV_CRC_update(0xFFFF, key), len);
+  while(len--) crc = KV_CRC_update(crc, *data++);
+  return (crc == KV_ERASED) ? 0 : crc;
+}
+
+// Check if page has a valid header
+static uint8_t KV_PAGE_valid(uint8_t page) {
+  uint32_t addr = KV_PAGE_ADDR(page);
+  return((uint16_t)~KV_read16(addr) == KV_read16(addr + 2));
+}
+
+// Check if page is completely erased
+static uint8_t KV_PAGE_blank(uint8_t page) {
+  uint32_t addr = KV_PAGE_ADDR(page);
+  uint8_t i;
+  for(i = FLASH_PAGE_SIZE / 4; i; i--, addr += 4) {
+    if(*(__IO uint32_t*)addr != 0xFFFFFFFF) return 0;
+  }
+  return 1;
+}
+
+// Get sequence number of page
+#define KV_PAGE_seq(p)    KV_read16(KV_PAGE_ADDR(p))
+
+// Find oldest valid page other than head (KV_NONE: none)
+static uint8_t KV_PAGE_oldest(void) {
+  uint8_t page, oldest = KV_NONE;
+  for(page = 0; page < KV_PAGES; page++) {
+    if((page == KV_head) || !KV_PAGE_valid(page)) continue;
+    if((oldest == KV_NONE) || ((int16_t)(KV_PAGE_seq(page) - KV_PAGE_seq(oldest)) < 0))
+      oldest = page;
+  }
+  return oldest;
+}
+
+// Find next erased page after head (KV_NONE: none), count erased pages
+static uint8_t KV_PAGE_next(uint8_t* count) {
+  uint8_t i, page = KV_head, next = KV_NONE;
+  *count = 0;
+  for(i = KV_PAGES - 1; i; i--) {
+    if(++page >= KV_PAGES) page = 0;
+    if(KV_PAGE_valid(page)) continue;
+    if(next == KV_NONE) next = page;
+    (*count)++;
+  }
+  return next;
+}
+
+// Make page the new head page with next sequence number
+static void KV_PAGE_open(uint8_t page) {
+  uint32_t addr = KV_PAGE_ADDR(page);
+  if(!KV_PAGE_blank(page)) FLASH_PAGE_erase(KV_FIRST_PAGE + page);
+  KV_seq++;
+  FLASH_write(addr,      KV_seq);
+  FLASH_write(addr + 2, ~KV_seq);                         // header is valid now
+  KV_head = page;
+  KV_wptr = KV_HEADER;
+}
+
+// Append record to head page (must fit), update index
+static void KV_append(uint8_t key, const uint8_t* data, uint8_t len) {
+  uint32_t addr = KV_PAGE_ADDR(KV_head) + KV_wptr;
+  uint32_t ptr  = addr + 2;
+  uint16_t crc  = KV_CRC(key, len, data);
+  uint8_t  i;
+  FLASH_write(addr, key | ((uint16_t)len << 8));          // key and length
+  for(i = 0; i < len; i += 2, ptr += 2) {                 // value
+    FLASH_write(ptr, data[i] | ((i + 1 < len) ? ((uint16_t)data[i + 1] << 8) : 0xFF00));
+  }
+  FLASH_write(ptr, crc);                                  // record is valid now
+  KV_wptr += KV_RECORD(len);
+  KV_index[key] = len ? (uint16_t)(addr - FLASH_BASE) : 0;
+}
+
+// Copy records of page which are still up to date into head page (must fit)
+static void KV_PAGE_copy(uint8_t page) {
+  uint32_t addr = KV_PAGE_ADDR(page) + KV_HEADER;
+  uint32_t end  = KV_PAGE_ADDR(page) + FLASH_PAGE_SIZE;
+  uint16_t header;
+  uint8_t  len;
+  while(addr + 4 <= end) {
+    header = KV_read16(addr);
+    if(header == KV_ERASED) break;
+    len = header >> 8;
+    if((uint8_t)header >= KV_KEYS || len > KV_MAX_LEN) break;
+    if((KV_index[(uint8_t)header] == (uint16_t)(addr - FLASH_BASE))
+    && (KV_wptr + KV_RECORD(len) <= FLASH_PAGE_SIZE))
+      KV_append((uint8_t)header, (const uint8_t*)(addr + 2), len);
+    addr += KV_RECORD(len);
+  }
+}
+
+// Open a new head page, compact oldest page first if only one erased page is left
+static void KV_PAGE_new(void) {
+  uint8_t count, oldest;
+  uint8_t next = KV_PAGE_next(&count);
+  if(next == KV_NONE) return;
+  oldest = (count < 2) ? KV_PAGE_oldest() : KV_NONE;
+  KV_PAGE_open(next);
+  if(oldest != KV_NONE) {
+    KV_PAGE_copy(oldest);                                 // keep current records
+    FLASH_PAGE_erase(KV_FIRST_PAGE + oldest);             // oldest page is spare now
+  }
+}
+
+// Scan records of page, update index, return write offset (page end if damaged)
+static uint8_t KV_PAGE_scan(uint8_t page) {
+  uint32_t base = KV_PAGE_ADDR(page);
+  uint32_t addr;
+  uint16_t header;
+  uint8_t  ptr = KV_HEADER;
+  uint8_t  key, len;
+  while(ptr + 4 <= FLASH_PAGE_SIZE) {
+    addr   = base + ptr;
+    header = KV_read16(addr);
+    if(header == KV_ERASED) return ptr;                   // free space starts here
+    key = header;
+    len = header >> 8;
+    if((key >= KV_KEYS) || (len > KV_MAX_LEN) || (ptr + KV_RECORD(len) > FLASH_PAGE_SIZE))
+      break;                                              // damaged: close page
+    if(KV_read16(addr + KV_RECORD(len) - 2) == KV_CRC(key, len, (const uint8_t*)(addr + 2)))
+      KV_index[key] = len ? (uint16_t)(addr - FLASH_BASE) : 0;
+    ptr += KV_RECORD(len);
+  }
+  return FLASH_PAGE_SIZE;
+}
+
+// Scan reserved pages and build RAM index
+void KV_init(void) {
+  uint8_t i, page, count;
+  FLASH_unlock();
+
+  // Clean up pages with damaged header, find head (page with highest seq)
+  KV_head = KV_NONE;
+  for(page = 0; page < KV_PAGES; page++) {
+    if(!KV_PAGE_valid(page)) {
+      if(!KV_PAGE_blank(page)) FLASH_PAGE_erase(KV_FIRST_PAGE + page);
+      continue;
+    }
+    if((KV_head == KV_NONE) || ((int16_t)(KV_PAGE_seq(page) - KV_seq) > 0)) {
+      KV_head = page;
+      KV_seq  = KV_PAGE_seq(page);
+    }
+  }
+  for(i = 0; i < KV_KEYS; i++) KV_index[i] = 0;
+
+  // Empty store: start with first page
+  if(KV_head == KV_NONE) {
+    KV_seq = 0xFFFF;
+    KV_PAGE_open(0);
+    FLASH_lock();
+    return;
+  }
+
+  // Scan pages from oldest to newest, the newest record of a key wins
+  page = KV_head;
+  for(i = KV_PAGES; i; i--) {
+    if(++page >= KV_PAGES) page = 0;
+    if(KV_PAGE_valid(page)) KV_wptr = KV_PAGE_scan(page);
+  }
+
+  // Power was lost during compaction: finish it
+  KV_PAGE_next(&count);
+  if(!count) {
+    page = KV_PAGE_oldest();
+    KV_PAGE_copy(page);
+    FLASH_PAGE_erase(KV_FIRST_PAGE + page);
+  }
+  FLASH_lock();
+}
+
+// Get length of value of key (0: key not found)
+uint8_t KV_length(uint8_t key) {
+  if((key >= KV_KEYS) || !KV_index[key]) return 0;
+  return KV_read8(FLASH_BASE + KV_index[key] + 1);
+}
+
+// Copy value of key into buffer (max maxlen bytes), return length of value
+uint8_t KV_read(uint8_t key, void* buf, uint8_t maxlen) {
+  uint8_t len = KV_length(key);
+  uint8_t i;
+  const uint8_t* src;
+  if(!len) return 0;
+  src = (const uint8_t*)(FLASH_BASE + KV_index[key] + 2);
+  for(i = 0; (i < len) && (i < maxlen); i++) ((uint8_t*)buf)[i] = src[i];
+  return len;
+}
+
+// Store new value of key (len 0: delete key), return 1 on success
+uint8_t KV_write(uint8_t key, const void* buf, uint8_t len) {
+  const uint8_t* data = (const uint8_t*)buf;
+  const uint8_t* old;
+  uint8_t i;
+  if((key >= KV_KEYS) || (len > KV_MAX_LEN)) return 0;
+
+  // Skip if value is unchanged
+  if(KV_length(key) == len) {
+    old = (const uint8_t*)(FLASH_BASE + KV_index[key] + 2);
+    for(i = 0; (i < len) && (old[i] == data[i]); i++);
+    if(i == len) return 1;
+  }
+
+  // Find room for record and append it
+  FLASH_unlock();
+  for(i = KV_PAGES; i && (KV_wptr + KV_RECORD(len) > FLASH_PAGE_SIZE); i--) KV_PAGE_new();
+  if(i) KV_append(key, data, len);
+  FLASH_lock();
+  return(i > 0);
+}
@@ -0,0 +1,59 @@
+// ===================================================================================
+// Log-Structured Key/Value Store in CODE FLASH for CH32V003                  * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// KV_init()                Scan reserved pages and build RAM index (call once at start)
+// KV_read(k, buf, n)       Copy value of key (k) into (buf) (max n bytes), return length
+//                          of value (0: key not found)
+// KV_write(k, buf, n)      Store (n) bytes from (buf) as new value of key (k), return 1
+//                          on success, 0 if key/length is invalid or store is full
+// KV_delete(k)             Remove key (k), return 1 on success
+// KV_length(k)             Get length of value of key (k) (0: key not found)
+//
+// KV_PAGES pages of 64 bytes starting at KV_FIRST_PAGE are used as a ring of log
+// pages. New values are appended as records with halfword writes, the old values are
+// left in place. Only when the current page is full, the next erased page is opened.
+// If only one erased page is left, the oldest page is compacted first: its records
+// that are still up to date are copied into the spare page, then it is erased. This
+// way, page erases are spread over all pages and happen only once per page of data.
+//
+// Page layout:   seq (16 bit), ~seq (16 bit), records...
+// Record layout: key (8 bit), length (8 bit), value (padded to halfwords), CRC16
+//
+// The page sequence numbers define the order of the pages, the CRC (written last)
+// marks a record as complete. If power is lost while writing, the incomplete record
+// or page is ignored (and cleaned up) on the next KV_init(), so the previous value is
+// still found. Unchanged values are not written again.
+//
+// The FLASH must not be locked by other code while calling KV_write(), KV_delete()
+// or KV_init(), they unlock and lock it themselves. The reserved pages must not be
+// used by the firmware itself (firmware size < KV_FIRST_PAGE * 64 bytes).
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "flash.h"
+
+// Key/value store parameters
+#define KV_FIRST_PAGE     240       // first reserved CODE FLASH page
+#define KV_PAGES          8         // number of reserved pages (min 3)
+#define KV_KEYS           16        // number of keys (0..KV_KEYS-1, max 256)
+#define KV_MAX_LEN        8         // max length of value in bytes (max 48)
+
+// Key/value store functions
+void KV_init(void);
+uint8_t KV_read(uint8_t key, void* buf, uint8_t maxlen);
+uint8_t KV_write(uint8_t key, const void* buf, uint8_t len);
+uint8_t KV_length(uint8_t key);
+#define KV_delete(k)      KV_write(k, 0, 0)
+
+#ifdef __cplusplus
+};
+#endif
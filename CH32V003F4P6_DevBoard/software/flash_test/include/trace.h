@@ -0,0 +1,61 @@
+// ===================================================================================
+// Binary Trace Log with Deferred Formatting for CH32V003                     * v1.1 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// TRACE(fmt, ...)          Send trace record with format string and up to 4 arguments
+//
+// Instead of formatting text on the microcontroller, TRACE() sends a compact binary
+// record via DEBUG_writeBuffer() (see debug_serial.h):
+//
+//   byte  0      TRACE_SYNC + number of arguments (0..4)
+//   bytes 1..2   format ID (little-endian)
+//   bytes 3..6   SysTick timestamp in F_CPU ticks (little-endian)
+//   bytes 7..    arguments, 32 bits each (little-endian)
+//
+// The format strings are placed in the ".trace" section, which the linker script keeps
+// in the ELF file as an INFO section, i.e. it does not occupy any FLASH. The format ID
+// is the offset of the string in this section. The host tool tools/tracedec.py reads
+// the strings from the ELF file and turns the records back into text. Bytes that are
+// not part of a record are passed through as text.
+//
+// Format strings must be string literals and are interpreted printf-style (%u, %d,
+// %x, %X and %c with optional zero flag and width, %s is not supported). Arguments
+// are integers of up to 32 bits. Records without arguments are printed verbatim, so
+// plain strings (e.g. from DEBUG_print) may contain '%' without escaping it. Set DEBUG_TRACE in debug_serial.h to 1 to route the
+// DEBUG_print functions through TRACE(). Keep the ELF file of the firmware for decoding
+// (e.g. 'make elf' or 'make trace').
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// Trace parameters
+#define TRACE_SYNC        0xA0              // record start byte (+ number of arguments)
+#define TRACE_TIME()      (STK->CNT)        // timestamp source (SysTick @ F_CPU)
+
+// Trace macro
+#define TRACE(fmt, ...) do {                                                    \
+  static const char TRACE_fmt[] __attribute__((section(".trace"), used)) = fmt; \
+  TRACE_emit((uint32_t)TRACE_fmt, TRACE_NARGS(__VA_ARGS__),                     \
+             TRACE_ARGS(_, ##__VA_ARGS__, 0, 0, 0, 0));                         \
+} while(0)
+
+// Helper macros to count and pad the arguments
+#define TRACE_NARGS(...)                  TRACE_NARGS_(_, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define TRACE_NARGS_(_, a, b, c, d, n, ...) n
+#define TRACE_ARGS(_, a, b, c, d, ...)    a, b, c, d
+
+// Trace functions
+void TRACE_emit(uint16_t id, uint8_t argc, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+#ifdef __cplusplus
+};
+#endif
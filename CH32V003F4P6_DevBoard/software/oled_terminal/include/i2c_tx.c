@@ -1,9 +1,10 @@
 // ===================================================================================
-// Basic I2C Master Functions (write only) for CH32V003                       * v1.1 *
+// Basic I2C Master Functions (write only) for CH32V003                       * v1.4 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #include "i2c_tx.h"
+#include "prof.h"
 
 // I2C event flag definitions
 #define I2C_START_GENERATED     0x00010003    // BUSY, MSL, SB
@@ -11,6 +12,14 @@
 #define I2C_BYTE_TRANSMITTED    0x00840003    // BUSY, MSL, BTF, TXE
 #define I2C_checkEvent(n)       (((((uint32_t)I2C1->STAR1<<16) | I2C1->STAR2) & n) == n)
 
+// Asynchronous transfer state
+volatile uint8_t I2C_async_busy  = 0;       // async transfer in progress
+volatile uint8_t I2C_async_error = 0;       // last async transfer aborted
+uint8_t          I2C_async_addr;            // slave address
+const uint8_t*   I2C_async_buf;             // data buffer
+uint16_t         I2C_async_len;             // number of bytes
+void (*I2C_async_callback)(void);           // callback when done
+
 // Init I2C
 void I2C_init(void) {
   #if I2C_MAP == 0
@@ -52,15 +61,25 @@ void I2C_init(void) {
 
   // Enable I2C
   I2C1->CTLR1 = I2C_CTLR1_PE;
+
+  // Setup DMA channel 6 (I2C1 TX) and interrupts for asynchronous transfer
+  RCC->AHBPCENR |= RCC_DMA1EN;
+  DMA1_Channel6->PADDR = (uint32_t)&I2C1->DATAR;
+  NVIC_EnableIRQ(I2C1_EV_IRQn);
+  NVIC_EnableIRQ(I2C1_ER_IRQn);
+  NVIC_EnableIRQ(DMA1_Channel6_IRQn);
 }
 
 // Start I2C transmission (addr must contain R/W bit)
 void I2C_start(uint8_t addr) {
+  PROF_BEGIN(PROF_I2C_START);
+  while(I2C_async_busy);                          // wait for async transfer
   while(I2C1->STAR2 & I2C_STAR2_BUSY);            // wait until bus ready
   I2C1->CTLR1 |= I2C_CTLR1_START;                 // set START condition
   while(!(I2C1->STAR1 & I2C_STAR1_SB));           // wait for START generated
   I2C1->DATAR = addr;                             // send slave address + R/W bit
   while(!I2C_checkEvent(I2C_ADDR_TRANSMITTED));   // wait for address transmitted
+  PROF_END(PROF_I2C_START);
 }
 
 // Send data byte via I2C bus
@@ -74,3 +93,74 @@ void I2C_stop(void) {
   while(!(I2C1->STAR1 & I2C_STAR1_BTF));          // wait for last byte transmitted
   I2C1->CTLR1 |= I2C_CTLR1_STOP;                  // set STOP condition
 }
+
+// Start asynchronous transfer of buffer via I2C (DMA and interrupts), 1: busy
+uint8_t I2C_writeBufferAsync(uint8_t addr, const uint8_t* buf, uint16_t len, void (*callback)(void)) {
+  if(I2C_async_busy) return 1;                    // last async transfer in progress
+  if(I2C1->STAR2 & I2C_STAR2_BUSY) return 1;      // bus not released yet (STOP)
+  I2C_async_addr     = addr;
+  I2C_async_buf      = buf;
+  I2C_async_len      = len;
+  I2C_async_callback = callback;
+  I2C_async_error    = 0;
+  I2C_async_busy     = 1;
+  I2C1->CTLR2 |= I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN; // enable I2C interrupts
+  I2C1->CTLR1 |= I2C_CTLR1_START;                 // set START condition
+  return 0;
+}
+
+// Finish asynchronous transfer (called from interrupt)
+void I2C_asyncDone(void) {
+  I2C1->CTLR1 |= I2C_CTLR1_STOP;                  // set STOP condition
+  I2C1->CTLR2 &= ~(I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN | I2C_CTLR2_DMAEN);
+  I2C_async_busy = 0;
+  if(I2C_async_callback) I2C_async_callback();
+}
+
+// I2C event interrupt service routine: START generated, address sent, last byte sent
+void I2C1_EV_IRQHandler(void) __attribute__((interrupt));
+void I2C1_EV_IRQHandler(void) {
+  uint16_t status = I2C1->STAR1;
+  PROF_BEGIN(PROF_I2C_IRQ);
+  if(status & I2C_STAR1_SB) {                     // START generated:
+    I2C1->DATAR = I2C_async_addr;                 // send slave address
+  }
+  else if(status & I2C_STAR1_ADDR) {              // address transmitted:
+    if(!I2C_async_len) {                          // nothing to send?
+      (void)I2C1->STAR2;                          // clear ADDR flag
+      I2C_asyncDone();                            // finish
+      PROF_END(PROF_I2C_IRQ);
+      return;
+    }
+    DMA1_Channel6->CFGR  = 0;                     // disable DMA channel
+    DMA1_Channel6->MADDR = (uint32_t)I2C_async_buf;
+    DMA1_Channel6->CNTR  = I2C_async_len;
+    DMA1_Channel6->CFGR  = DMA_CFGR1_MINC         // increment memory address
+                         | DMA_CFGR1_DIR          // memory to peripheral
+                         | DMA_CFGR1_TCIE         // transfer complete interrupt enable
+                         | DMA_CFGR1_EN;          // enable
+    I2C1->CTLR2 = (I2C1->CTLR2 & ~I2C_CTLR2_ITEVTEN) | I2C_CTLR2_DMAEN;
+    (void)I2C1->STAR2;                            // clear ADDR flag, DMA takes over
+  }
+  else if(status & I2C_STAR1_BTF) {               // last byte transmitted:
+    I2C_asyncDone();                              // set STOP and finish
+  }
+  PROF_END(PROF_I2C_IRQ);
+}
+
+// I2C error interrupt service routine: abort transfer (e.g. slave NACK)
+void I2C1_ER_IRQHandler(void) __attribute__((interrupt));
+void I2C1_ER_IRQHandler(void) {
+  I2C1->STAR1 = 0;                                // clear error flags
+  DMA1_Channel6->CFGR = 0;                        // stop DMA
+  I2C_async_error = 1;
+  I2C_asyncDone();
+}
+
+// DMA interrupt service routine: all bytes handed over to I2C
+void DMA1_Channel6_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel6_IRQHandler(void) {
+  DMA1->INTFCR = DMA_CGIF6;                       // clear interrupt flags
+  DMA1_Channel6->CFGR = 0;                        // disable DMA channel
+  I2C1->CTLR2 = (I2C1->CTLR2 & ~I2C_CTLR2_DMAEN) | I2C_CTLR2_ITEVTEN; // wait for BTF
+}
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic I2C Master Functions (write only) for CH32V003                       * v1.1 *
+// Basic I2C Master Functions (write only) for CH32V003                       * v1.4 *
 // ===================================================================================
 //
 // Functions available:
@@ -9,6 +9,23 @@
 // I2C_write(b)             I2C transmit one data byte via I2C
 // I2C_stop()               I2C stop transmission
 //
+// I2C_writeBufferAsync(addr, buf, len, callback)
+//                          Send len bytes from buf to slave addr in the background
+//                          using DMA and I2C interrupts, callback (or 0) is called
+//                          from interrupt when done; buf must stay valid until then.
+//                          Returns 0 if started, 1 if busy (nothing is sent then)
+// I2C_busy()               Check if an asynchronous transfer is in progress
+// I2C_failed()             Check if last asynchronous transfer was aborted (NACK)
+// I2C_wait()               Wait until asynchronous transfer is completed
+//
+// The asynchronous transfer uses DMA1 channel 6 (I2C1 TX) for the data bytes, the
+// I2C event interrupt generates START, address and STOP. SYS_USE_VECTORS in
+// system.h must be set to 1. I2C_writeBufferAsync() never waits: it reports busy
+// while a transfer is in progress or the bus has not been released after the last
+// STOP yet. Since the STOP takes a few microseconds and the master gets no interrupt
+// when it is done, a transfer started from the callback usually finds the bus busy;
+// retry it from the main loop then.
+//
 // I2C pin mapping (set below in I2C parameters):
 // ----------------------------------------------
 // I2C_MAP    0     1     2
@@ -24,7 +41,7 @@
 extern "C" {
 #endif
 
-#include "ch32v003.h"
+#include "system.h"
 
 // I2C Parameters
 #define I2C_CLKRATE   400000    // I2C bus clock rate (Hz)
@@ -36,6 +53,14 @@ void I2C_start(uint8_t addr);   // I2C start transmission, addr must contain R/W
 void I2C_write(uint8_t data);   // I2C transmit one data byte via I2C
 void I2C_stop(void);            // I2C stop transmission
 
+// I2C Asynchronous Transfer
+extern volatile uint8_t I2C_async_busy;
+extern volatile uint8_t I2C_async_error;
+#define I2C_busy()    (I2C_async_busy)    // check if async transfer is in progress
+#define I2C_failed()  (I2C_async_error)   // check if last async transfer failed
+#define I2C_wait()    while(I2C_async_busy) // wait for async transfer to complete
+uint8_t I2C_writeBufferAsync(uint8_t addr, const uint8_t* buf, uint16_t len, void (*callback)(void));
+
 #ifdef __cplusplus
 };
 #endif
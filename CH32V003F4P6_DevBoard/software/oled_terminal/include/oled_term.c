@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.1 *
+// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.6 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306 128x64 pixels
@@ -17,6 +17,7 @@
 // 2022 by Stefan Wagner: https://github.com/wagiminator
 
 #include "oled_term.h"
+#include "prof.h"
 
 // Standard ASCII 5x8 font (chars 32 - 127)
 const uint8_t OLED_FONT[] = {
@@ -58,7 +59,11 @@ const uint8_t OLED_FONT[] = {
 const uint8_t OLED_INIT_CMD[] = {
   OLED_MULTIPLEX,   0x3F,                 // set multiplex ratio  
   OLED_CHARGEPUMP,  0x14,                 // set DC-DC enable  
+  #if OLED_BUFFERED == 1
+  OLED_MEMORYMODE,  0x00,                 // set horizontal addressing mode
+  #else
   OLED_MEMORYMODE,  0x02,                 // set page addressing mode
+  #endif
   OLED_COMPINS,     0x12,                 // set com pins
   OLED_XFLIP, OLED_YFLIP,                 // flip screen
   OLED_DISPLAY_ON                         // display on
@@ -67,6 +72,59 @@ const uint8_t OLED_INIT_CMD[] = {
 // OLED global variables
 uint8_t line, column, scroll;
 
+#if OLED_BUFFERED == 1
+// OLED framebuffer page, prefixed with the commands to set the page address
+typedef struct {
+  uint8_t cmd[7];                         // control and command bytes
+  uint8_t data[128];                      // pixel data
+} OLED_PAGE_t;
+
+OLED_PAGE_t OLED_page[8];                 // framebuffer
+volatile uint8_t OLED_dirty    = 0;       // dirty bit for each page
+volatile uint8_t OLED_flushing = 0;       // framebuffer is being sent
+volatile uint8_t OLED_scrolled = 0;       // display offset needs to be sent
+uint8_t OLED_scrollCmd[3] = {OLED_CMD_MODE, OLED_OFFSET, 0};
+
+// OLED set cursor to line start (cursor is only used when plotting into framebuffer)
+#define OLED_setline(l)
+
+// OLED clear line
+void OLED_clearline(uint8_t line) {
+  uint8_t i;
+  for(i=0; i<128; i++) OLED_page[line].data[i] = 0x00;
+  OLED_dirty |= 1 << line;
+}
+
+// OLED send next dirty page or display offset (called from interrupt when flushing)
+void OLED_flushNext(void) {
+  uint8_t i;
+  for(i=0; i<8; i++) {
+    if(OLED_dirty & (1 << i)) {
+      OLED_dirty &= ~(1 << i);            // page will be up to date
+      if(!I2C_writeBufferAsync(OLED_ADDR, (uint8_t*)&OLED_page[i], sizeof(OLED_PAGE_t),
+                               OLED_flushNext)) return;
+      OLED_dirty |= 1 << i;               // I2C busy: page stays dirty
+      OLED_flushing = 0;                  // retry with next OLED_flush()
+      return;
+    }
+  }
+  if(OLED_scrolled) {
+    OLED_scrolled = 0;
+    OLED_scrollCmd[2] = scroll << 3;
+    if(!I2C_writeBufferAsync(OLED_ADDR, OLED_scrollCmd, sizeof(OLED_scrollCmd),
+                             OLED_flushNext)) return;
+    OLED_scrolled = 1;                    // I2C busy: offset is still to be sent
+  }
+  OLED_flushing = 0;                      // all done (or retry with next OLED_flush())
+}
+
+// OLED send dirty pages of framebuffer (in the background)
+void OLED_flush(void) {
+  if(OLED_flushing || !(OLED_dirty || OLED_scrolled)) return;
+  OLED_flushing = 1;
+  OLED_flushNext();
+}
+#else
 // OLED set cursor to line start
 void OLED_setline(uint8_t line) {
   I2C_start(OLED_ADDR);                   // start transmission to OLED
@@ -85,12 +143,13 @@ void OLED_clearline(uint8_t line) {
   for(i=128; i; i--) I2C_write(0x00);     // clear the line
   I2C_stop();                             // stop transmission
 }
+#endif
 
 // OLED clear screen
 void OLED_clear(void) {
   uint8_t i;
   for(i=0; i<8; i++) OLED_clearline(i);
-  line = scroll;
+  line = 0;
   column = 0;
   OLED_setline((line + scroll) & 0x07);
 }
@@ -99,11 +158,15 @@ void OLED_clear(void) {
 void OLED_scrollDisplay(void) {
   OLED_clearline(scroll);                 // clear line
   scroll = (scroll + 1) & 0x07;           // set next line
+  #if OLED_BUFFERED == 1
+  OLED_scrolled = 1;                      // send display offset with next flush
+  #else
   I2C_start(OLED_ADDR);                   // start transmission to OLED
   I2C_write(OLED_CMD_MODE);               // set command mode
   I2C_write(OLED_OFFSET);                 // set display offset:
   I2C_write(scroll << 3);                 // scroll up
   I2C_stop();                             // stop transmission
+  #endif
 }
 
 // OLED init function
@@ -115,45 +178,102 @@ void OLED_init(void) {
   for(i = 0; i < sizeof(OLED_INIT_CMD); i++)
     I2C_write(OLED_INIT_CMD[i]);          // send the command bytes
   I2C_stop();                             // stop transmission
+  #if OLED_BUFFERED == 1
+  for(i=0; i<8; i++) {                    // prepare page address commands
+    OLED_page[i].cmd[0] = OLED_CMD_NEXT; OLED_page[i].cmd[1] = OLED_PAGES;
+    OLED_page[i].cmd[2] = OLED_CMD_NEXT; OLED_page[i].cmd[3] = i;
+    OLED_page[i].cmd[4] = OLED_CMD_NEXT; OLED_page[i].cmd[5] = 7;
+    OLED_page[i].cmd[6] = OLED_DAT_MODE;
+  }
+  #endif
   scroll = 0;                             // start with zero scroll
   OLED_clear();                           // clear screen
+  OLED_flush();                           // send framebuffer
 }
 
-// OLED plot a single character
-void OLED_plotChar(char c) {
+// OLED plot a run of n printable characters at cursor position (same line)
+void OLED_plotChars(const char* str, uint8_t n) {
   uint8_t i;
-  uint16_t ptr = c - 32;                  // character pointer
-  ptr += ptr << 2;                        // -> ptr = (ch - 32) * 5;
+  uint16_t ptr;
+  #if OLED_BUFFERED == 1
+  uint8_t page = (line + scroll) & 0x07;  // page of current line
+  uint8_t* dst = &OLED_page[page].data[column * 6];
+  OLED_dirty |= 1 << page;                // mark page as dirty
+  while(n--) {
+    ptr  = (*str++ & 0x7F) - 32;          // character pointer
+    ptr += ptr << 2;                      // -> ptr = (ch - 32) * 5;
+    for(i=5 ; i; i--) *dst++ = OLED_FONT[ptr++];
+    *dst++ = 0x00;                        // space between characters
+  }
+  #else
   I2C_start(OLED_ADDR);                   // start transmission to OLED
   I2C_write(OLED_DAT_MODE);               // set data mode
-  for(i=5 ; i; i--) I2C_write(OLED_FONT[ptr++]);
-  I2C_write(0x00);                        // write space between characters
+  while(n--) {
+    ptr  = (*str++ & 0x7F) - 32;          // character pointer
+    ptr += ptr << 2;                      // -> ptr = (ch - 32) * 5;
+    for(i=5 ; i; i--) I2C_write(OLED_FONT[ptr++]);
+    I2C_write(0x00);                      // write space between characters
+  }
   I2C_stop();                             // stop transmission
+  #endif
+}
+
+// OLED move cursor to start of next line, scroll if necessary
+void OLED_nextLine(void) {
+  column = 0;
+  if(line == 7) OLED_scrollDisplay();
+  else line++;
+  OLED_setline((line + scroll) & 0x07);
 }
 
 // OLED write a character or handle control characters
 void OLED_write(char c) {
+  PROF_BEGIN(PROF_OLED_WRITE);
   c = c & 0x7F;                           // ignore top bit
   // normal character
   if(c >= 32) {
-    OLED_plotChar(c);
-    if(++column > 20) {
-      column = 0;
-      if(line == 7) OLED_scrollDisplay();
-      else line++;
-      OLED_setline((line + scroll) & 0x07);
-    }
+    OLED_plotChars(&c, 1);
+    if(++column > 20) OLED_nextLine();
   }
   // new line
-  else if(c == '\n') {
-    column = 0;
-    if(line == 7) OLED_scrollDisplay();
-    else line++;
-    OLED_setline((line + scroll) & 0x07);
-  }
+  else if(c == '\n') OLED_nextLine();
   // carriage return
   else if(c == '\r') {
     column = 0;
     OLED_setline((line + scroll) & 0x07);
   }
+  PROF_END(PROF_OLED_WRITE);
+}
+
+// OLED write n characters, runs of printable characters on the same line are sent
+// in one single transaction
+void OLED_writeN(const char* str, uint16_t len) {
+  uint8_t n;
+  while(len) {
+    n = 0;                                // count printable chars fitting on line
+    while((n < len) && (column + n <= 20) && ((str[n] & 0x7F) >= 32)) n++;
+    if(!n) {                              // control character:
+      OLED_write(*str++);                 // handle it
+      len--;
+      continue;
+    }
+    OLED_plotChars(str, n);               // plot run of characters
+    str    += n;
+    len    -= n;
+    column += n;
+    if(column > 20) OLED_nextLine();      // wrap at end of line
+  }
+}
+
+// OLED print string
+void OLED_printS(const char* str) {
+  const char* end = str;
+  while(*end) end++;
+  OLED_writeN(str, end - str);
+}
+
+// OLED print string with newline
+void OLED_println(const char* str) {
+  OLED_printS(str);
+  OLED_nextLine();
 }
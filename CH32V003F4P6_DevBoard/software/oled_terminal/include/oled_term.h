@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.1 *
+// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.6 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306 128x64 pixels
@@ -10,15 +10,30 @@
 // OLED_init()              Init OLED display
 // OLED_clear()             Clear screen of OLED display
 // OLED_write(c)            Write a character or handle control characters
+// OLED_writeN(s,n)         Write n characters, one I2C transaction per run on a line
+// OLED_printS(s)           Print string (via OLED_writeN)
+// OLED_println(s)          Print string with newline (via OLED_writeN)
+// OLED_flush()             Send changed pages of framebuffer to OLED (if buffered)
+// OLED_busy()              Check if framebuffer is currently being sent (if buffered)
 //
-// If print functions are activated (see below, print.h must be included):
+// If OLED_BUFFERED is set, all writes go into a shadow framebuffer in RAM (8 pages x
+// 128 columns) and changed pages are marked dirty. OLED_flush() sends only the dirty
+// pages, each in one single I2C transaction in horizontal addressing mode, in the
+// background via DMA (see I2C_writeBufferAsync). It returns immediately, so call it
+// regularly (e.g. whenever there is nothing else to do). The next page is chained
+// from the transfer-complete interrupt; if the I2C bus has not been released after
+// the last STOP yet, the remaining pages are sent by the next call of OLED_flush()
+// instead of waiting in the interrupt. Needs 1080 bytes of RAM.
+//
+// If print functions are activated (see below, print.h must be included), they send
+// complete strings through OLED_writeN (block-write sink):
 // OLED_printD(n)           Print decimal value
+// OLED_printI(n)           Print signed decimal value
+// OLED_printF(n,d)         Print fixed-point value n with d decimals
 // OLED_printW(n)           Print 32-bit hex word value
 // OLED_printH(n)           Print 16-bit hex half-word value
 // OLED_printB(n)           Print  8-bit hex byte value
-// OLED_printS(s)           Print string
 // OLED_print(s)            Print string (alias)
-// OLED_println(s)          Print string with newline
 // OLED_newline()           Send newline
 //
 // References:
@@ -42,11 +57,13 @@ extern "C" {
 
 // OLED parameters
 #define OLED_PRINT        1       // 1: include print functions (needs print.h)
+#define OLED_BUFFERED     1       // 1: use framebuffer with dirty-page flushing
 
 // OLED definitions
 #define OLED_ADDR         0x78    // OLED write address (0x3C << 1)
 #define OLED_CMD_MODE     0x00    // set command mode
 #define OLED_DAT_MODE     0x40    // set data mode
+#define OLED_CMD_NEXT     0x80    // next byte is command, followed by control byte
 
 // OLED commands
 #define OLED_COLUMN_LOW   0x00    // set lower 4 bits of start column (0x00 - 0x0F)
@@ -74,16 +91,28 @@ extern "C" {
 void OLED_init(void);             // OLED init function
 void OLED_clear(void);            // OLED clear screen
 void OLED_write(char c);          // OLED write a character or handle control characters
+void OLED_writeN(const char* str, uint16_t len);  // OLED write n characters
+void OLED_printS(const char* str);                // OLED print string
+void OLED_println(const char* str);               // OLED print string with newline
+
+#if OLED_BUFFERED == 1
+void OLED_flush(void);            // OLED send dirty pages of framebuffer
+extern volatile uint8_t OLED_flushing;
+#define OLED_busy()       (OLED_flushing)
+#else
+#define OLED_flush()                      // nothing to do in unbuffered mode
+#define OLED_busy()       (0)
+#endif
 
 // Additional print functions (if activated, see above)
 #if OLED_PRINT == 1
 #include "print.h"
-#define OLED_printD(n)    printD(n, OLED_write)   // print decimal as string
-#define OLED_printW(n)    printW(n, OLED_write)   // print word as string
-#define OLED_printH(n)    printH(n, OLED_write)   // print half-word as string
-#define OLED_printB(n)    printB(n, OLED_write)   // print byte as string
-#define OLED_printS(s)    printS(s, OLED_write)   // print string
-#define OLED_println(s)   println(s, OLED_write)  // print string with newline
+#define OLED_printD(n)    writeD(n, OLED_writeN)  // print decimal as string
+#define OLED_printI(n)    writeI(n, OLED_writeN)  // print signed decimal as string
+#define OLED_printF(n,d)  writeF(n, d, OLED_writeN) // print fixed-point value
+#define OLED_printW(n)    writeW(n, OLED_writeN)  // print word as string
+#define OLED_printH(n)    writeH(n, OLED_writeN)  // print half-word as string
+#define OLED_printB(n)    writeB(n, OLED_writeN)  // print byte as string
 #define OLED_print        OLED_printS             // alias
 #define OLED_newline()    OLED_write('\n')        // send newline
 #endif
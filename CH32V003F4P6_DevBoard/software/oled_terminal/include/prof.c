@@ -0,0 +1,87 @@
+// ===================================================================================
+// Profiling Probes for CH32V003                                              * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "prof.h"
+
+#if PROF_ENABLE > 0
+
+PROF_PROBE_t PROF_probe[PROF_MAX];                        // probe statistics
+static uint32_t PROF_overhead;                            // ticks of empty probe
+static const char* const PROF_name[PROF_MAX] = {PROF_NAMES};
+
+// Reset all probes
+void PROF_reset(void) {
+  PROF_PROBE_t* p = PROF_probe;
+  uint8_t i, k;
+  for(i = PROF_MAX; i; i--, p++) {
+    p->count = 0;
+    p->min   = 0xFFFFFFFF;
+    p->max   = 0;
+    p->total = 0;
+    for(k = 0; k < PROF_BUCKETS; k++) p->hist[k] = 0;
+  }
+}
+
+// Reset all probes and measure overhead of an empty probe
+void PROF_init(void) {
+  PROF_overhead = 0;
+  PROF_reset();
+  PROF_BEGIN(0);
+  PROF_END(0);
+  PROF_overhead = PROF_probe[0].min;
+  PROF_reset();
+}
+
+// Record one measurement of probe id
+void PROF_record(uint8_t id, uint32_t ticks) {
+  PROF_PROBE_t* p = &PROF_probe[id];
+  uint8_t bucket = 0;
+  ticks = (ticks > PROF_overhead) ? ticks - PROF_overhead : 0;
+  p->count++;
+  p->total += ticks;
+  if(ticks < p->min) p->min = ticks;
+  if(ticks > p->max) p->max = ticks;
+  while((ticks >>= 1) && (bucket < PROF_BUCKETS - 1)) bucket++;
+  if(p->hist[bucket] != 0xFFFF) p->hist[bucket]++;
+}
+
+// Write label and decimal value
+static void PROF_writeValue(const char* label, uint32_t value, PRINT_SINK_t write) {
+  writeS(label, write);
+  writeD(value, write);
+}
+
+// Print statistics of all probes (ticks at F_CPU) via block-write sink. Histogram
+// buckets are printed as "k:count" for all non-empty buckets (2^k..2^(k+1)-1 ticks).
+void PROF_dump(PRINT_SINK_t write) {
+  PROF_PROBE_t* p = PROF_probe;
+  uint64_t total;
+  uint32_t count;
+  uint8_t  i, k;
+  for(i = 0; i < PROF_MAX; i++, p++) {
+    writeS(PROF_name[i], write);
+    PROF_writeValue(" n=", p->count, write);
+    if(p->count) {
+      total = p->total;                                   // average without
+      count = p->count;                                   // 64-bit division
+      while(total >> 32) {
+        total >>= 1;
+        count >>= 1;
+      }
+      PROF_writeValue(" min=", p->min, write);
+      PROF_writeValue(" avg=", count ? (uint32_t)total / count : 0, write);
+      PROF_writeValue(" max=", p->max, write);
+      writeS("\n hist", write);
+      for(k = 0; k < PROF_BUCKETS; k++) {
+        if(!p->hist[k]) continue;
+        PROF_writeValue(" ", k, write);
+        PROF_writeValue(":", p->hist[k], write);
+      }
+    }
+    writeS("\n", write);
+  }
+}
+
+#endif
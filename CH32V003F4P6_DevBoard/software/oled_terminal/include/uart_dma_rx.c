@@ -1,9 +1,10 @@
 // ===================================================================================
-// UART with DMA (RX only) for CH32V003                                       * v1.1 *
+// UART with DMA (RX only) for CH32V003                                       * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #include "uart_dma_rx.h"
+#include "prof.h"
 
 // Circular RX buffer
 char UART_RX_buffer[UART_RX_BUF_SIZE];
@@ -74,8 +75,10 @@ uint8_t UART_available(void) {
 // Read from UART buffer
 char UART_read(void) {
   char result;
+  PROF_BEGIN(PROF_UART_READ);
   while(!UART_available());
   result = UART_RX_buffer[UART_RX_tptr++];
   if(UART_RX_tptr >= UART_RX_BUF_SIZE) UART_RX_tptr = 0;
+  PROF_END(PROF_UART_READ);
   return result;
 }
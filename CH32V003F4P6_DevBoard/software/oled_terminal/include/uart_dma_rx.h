@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA (RX only) for CH32V003                                       * v1.1 *
+// UART with DMA (RX only) for CH32V003                                       * v1.2 *
 // ===================================================================================
 //
 // Functions available:
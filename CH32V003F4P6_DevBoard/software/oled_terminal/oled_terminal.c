@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   OLED Terminal Demo for CH32V003
-// Version:   v1.0
+// Version:   v1.4
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,7 +10,15 @@
 //
 // Description:
 // ------------
-// Displays text sent via UART on an SSD1306 128x64 pixels OLED.
+// Displays text sent via UART on an SSD1306 128x64 pixels OLED. Receiving and
+// rendering are decoupled: characters from the UART DMA buffer are moved into a
+// character queue, which is rendered in batches into the framebuffer at a fixed
+// frame rate (or earlier if the queue gets half full). The framebuffer is then sent
+// to the OLED in the background. If a batch contains more newlines than the screen
+// has lines, the screen is cleared once instead of scrolling line by line.
+// TERM_queued and TERM_dropped count received and dropped characters.
+// If PROF_ENABLE is set to 1 in prof.h, sending CTRL-P (0x10) shows the cycle
+// statistics of the profiling probes in the OLED, I2C and UART drivers.
 //
 // References:
 // -----------
@@ -32,14 +40,79 @@
 #include <gpio.h>             // GPIO functions
 #include <uart_dma_rx.h>      // UART RX functions
 #include <oled_term.h>        // OLED terminal functions
+#include <prof.h>             // profiling probes
+
+#define TERM_QUEUE_SIZE   256         // character queue size (power of 2)
+#define TERM_FPS          25          // OLED frame rate (frames per second)
+#define TERM_LINES        8           // number of lines on screen
+#define TERM_FRAME_TICKS  (F_CPU / TERM_FPS)
+#define TERM_MASK         (TERM_QUEUE_SIZE - 1)
+#define TERM_PROF_KEY     0x10        // CTRL-P: show profiling statistics
+
+// ===================================================================================
+// Terminal Character Queue and Renderer
+// ===================================================================================
+char     TERM_queue[TERM_QUEUE_SIZE]; // character queue
+uint16_t TERM_head    = 0;            // write index (free running)
+uint16_t TERM_tail    = 0;            // read index (free running)
+uint32_t TERM_queued  = 0;            // number of characters queued
+uint32_t TERM_dropped = 0;            // number of characters dropped (queue full)
+uint8_t  TERM_profile = 0;            // profiling statistics requested
+
+// Move received characters from UART DMA buffer into character queue
+void TERM_receive(void) {
+  while(UART_available()) {
+    char c = UART_read();
+    #if PROF_ENABLE > 0
+    if(c == TERM_PROF_KEY) {
+      TERM_profile = 1;
+      continue;
+    }
+    #endif
+    if((uint16_t)(TERM_head - TERM_tail) < TERM_QUEUE_SIZE) {
+      TERM_queue[TERM_head++ & TERM_MASK] = c;
+      TERM_queued++;
+    }
+    else TERM_dropped++;
+  }
+}
+
+// Render all queued characters into framebuffer
+void TERM_render(void) {
+  uint16_t head = TERM_head;
+  uint16_t tail = TERM_tail;
+  uint16_t pos, len;
+  uint8_t  newlines = 0;
+
+  // Everything before the last TERM_LINES newlines would be scrolled out anyway
+  for(pos = head; pos != tail; ) {
+    if((TERM_queue[--pos & TERM_MASK] == '\n') && (++newlines == TERM_LINES)) {
+      OLED_clear();                   // clear once instead of scrolling
+      tail = pos + 1;                 // skip invisible text
+      break;
+    }
+  }
+
+  // Render remaining characters in up to two contiguous runs
+  while(tail != head) {
+    pos = tail & TERM_MASK;
+    len = head - tail;
+    if(len > TERM_QUEUE_SIZE - pos) len = TERM_QUEUE_SIZE - pos;
+    OLED_writeN(&TERM_queue[pos], len);
+    tail += len;
+  }
+  TERM_tail = tail;
+}
 
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
   // Setup
+  uint32_t frametime;         // time of last frame
   UART_init();                // init UART
   OLED_init();                // init OLED
+  PROF_init();                // init profiling probes
   
   // Print start message
   OLED_print("UART TO OLED TERMINAL");
@@ -48,7 +121,19 @@ int main(void) {
   OLED_print("_\r");
 
   // Loop
+  frametime = STK->CNT;
   while(1) {
-    OLED_write(UART_read());  // print incoming character on OLED
+    TERM_receive();                                 // queue incoming characters
+    if( ((uint32_t)(STK->CNT - frametime) >= TERM_FRAME_TICKS)
+     || ((uint16_t)(TERM_head - TERM_tail) >= TERM_QUEUE_SIZE / 2) ) {
+      frametime = STK->CNT;
+      TERM_render();                                // render queue into framebuffer
+      if(TERM_profile) {
+        TERM_profile = 0;
+        PROF_dump(OLED_writeN);                     // show probe statistics
+        PROF_reset();
+      }
+    }
+    OLED_flush();                                   // update OLED in the background
   }
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic System Functions for CH32V003                                        * v1.4 *
+// Basic System Functions for CH32V003                                        * v1.5 *
 // ===================================================================================
 //
 // This file must be included!!!!
@@ -103,6 +103,39 @@ void DLY_ticks(uint32_t n) {
   while(((int32_t)(STK->CNT - end)) < 0);
 }
 
+// ===================================================================================
+// Timestamp Functions
+// ===================================================================================
+
+// Number of half wraps (2^31 ticks) of SYSTICK counter seen so far. Bit 0 always
+// mirrors the MSB of the counter at the last read. Placed in .data, so it is zero
+// at startup even if SYS_CLEAR_BSS is disabled.
+static volatile uint32_t TIME_halfwraps __attribute__((section(".data"))) = 0;
+
+// Get 64-bit number of system ticks since start. Lock-free: if the MSB of the counter
+// differs from bit 0 of the half wrap count, a half wrap has happened. An interrupt
+// doing the same between load and store writes the identical value, so no update
+// can get lost as long as the function is called at least once every 2^31 ticks.
+uint64_t TIME_cycles(void) {
+  uint32_t halfwraps = TIME_halfwraps;
+  uint32_t cnt       = STK->CNT;
+  if((cnt >> 31) != (halfwraps & 1)) TIME_halfwraps = ++halfwraps;
+  return ((uint64_t)(halfwraps >> 1) << 32) | cnt;
+}
+
+// Get 64-bit number of microseconds since start. Long division in 16-bit steps with
+// 32-bit operations only, so no 64-bit division routine is needed.
+uint64_t TIME_micros64(void) {
+  uint64_t ticks = TIME_cycles();
+  uint32_t hi    = ticks >> 32;
+  uint32_t lo    = ticks;
+  uint32_t qh    = hi / DLY_US_TIME;
+  uint32_t r     = ((hi % DLY_US_TIME) << 16) | (lo >> 16);
+  uint32_t qm    = r / DLY_US_TIME;
+  r = ((r % DLY_US_TIME) << 16) | (lo & 0xFFFF);
+  return ((uint64_t)qh << 32) + ((uint64_t)qm << 16) + (r / DLY_US_TIME);
+}
+
 // ===================================================================================
 // Independent Watchdog Timer (IWDG) Functions
 // ===================================================================================
@@ -0,0 +1,81 @@
+// ===================================================================================
+// Profiling Probes for CH32V003                                              * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// PROF_BEGIN(id)           Start measurement of probe id (read SYSTICK counter)
+// PROF_END(id)             Stop measurement of probe id and record elapsed ticks
+// PROF_init()              Reset all probes and calibrate probe overhead
+// PROF_reset()             Reset all probes
+// PROF_dump(write)         Print statistics of all probes via write(buf, len) function
+//                          (e.g. UART_writeBuffer, OLED_writeN, DEBUG_writeBuffer)
+//
+// Each probe accumulates count, min, max and total number of system ticks (F_CPU
+// cycles, see STK_init in system.h) between PROF_BEGIN and PROF_END, and a histogram
+// with logarithmic buckets: bucket 0 counts 0..1 ticks, bucket k counts 2^k..2^(k+1)-1
+// ticks, the last bucket counts everything above. The probe overhead measured by
+// PROF_init() is subtracted. A probe must not be nested with itself and should only
+// be used in one context (either main loop or one interrupt).
+//
+// If PROF_ENABLE is set to 0, all macros are compiled out to nothing, so the probes
+// can stay in the code.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+#include "print.h"
+
+// Profiling parameters
+#define PROF_ENABLE       0         // 1: enable profiling probes
+#define PROF_BUCKETS      16        // number of histogram buckets (max 32)
+
+// Probe IDs and names
+#define PROF_UART_READ    0         // UART_read()
+#define PROF_UART_WRITE   1         // UART_writeBuffer()
+#define PROF_UART_IRQ     2         // USART1_IRQHandler()
+#define PROF_UART_TX_IRQ  3         // DMA1_Channel4_IRQHandler()
+#define PROF_MAX          4         // number of probes
+#define PROF_NAMES        "UART_read", "UART_writeBuffer", "UART_IRQ", "UART_TX_IRQ"
+
+#if PROF_ENABLE > 0
+
+// Probe statistics
+typedef struct {
+  uint32_t start;                   // SYSTICK counter at PROF_BEGIN
+  uint32_t count;                   // number of measurements
+  uint32_t min;                     // minimum ticks
+  uint32_t max;                     // maximum ticks
+  uint64_t total;                   // sum of ticks
+  uint16_t hist[PROF_BUCKETS];      // histogram (saturating)
+} PROF_PROBE_t;
+
+extern PROF_PROBE_t PROF_probe[PROF_MAX];
+
+#define PROF_BEGIN(id)    PROF_probe[id].start = STK->CNT
+#define PROF_END(id)      PROF_record(id, STK->CNT - PROF_probe[id].start)
+
+void PROF_init(void);                                   // reset and calibrate
+void PROF_reset(void);                                  // reset all probes
+void PROF_record(uint8_t id, uint32_t ticks);           // record one measurement
+void PROF_dump(PRINT_SINK_t write);                     // print statistics
+
+#else
+
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+#define PROF_init()
+#define PROF_reset()
+#define PROF_dump(write)
+
+#endif
+
+#ifdef __cplusplus
+};
+#endif
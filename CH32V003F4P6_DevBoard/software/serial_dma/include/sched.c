@@ -0,0 +1,90 @@
+// ===================================================================================
+// Cooperative Run-to-Completion Task Scheduler for CH32V003                  * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "sched.h"
+
+// Task slots
+typedef struct {
+  SCHED_TASK_t     task;                          // task function
+  uint8_t          prio;                          // priority (higher runs first)
+  volatile uint8_t events;                        // pending event flags
+} SCHED_SLOT_t;
+
+SCHED_SLOT_t SCHED_slot[SCHED_MAX];               // task slots
+uint8_t SCHED_count;                              // number of tasks
+uint8_t SCHED_last;                               // last task run (round-robin)
+void (*SCHED_idleHook)(void);                     // called when nothing is pending
+
+// Disable interrupts and restore previous state afterwards
+#define SCHED_lock()      uint32_t mstatus = __get_MSTATUS(); __disable_irq()
+#define SCHED_unlock()    __set_MSTATUS(mstatus)
+
+// Init scheduler
+void SCHED_init(void) {
+  SCHED_count    = 0;
+  SCHED_last     = 0;
+  SCHED_idleHook = SLEEP_WFI_now;
+}
+
+// Add task with priority, return task ID
+uint8_t SCHED_add(SCHED_TASK_t task, uint8_t prio) {
+  uint8_t id = SCHED_count;
+  if(id >= SCHED_MAX) return SCHED_NONE;
+  SCHED_slot[id].task   = task;
+  SCHED_slot[id].prio   = prio;
+  SCHED_slot[id].events = 0;
+  SCHED_count = id + 1;
+  return id;
+}
+
+// Set event flags of task (interrupt-safe)
+void SCHED_post(uint8_t id, uint8_t events) {
+  SCHED_lock();
+  SCHED_slot[id].events |= events;
+  SCHED_unlock();
+}
+
+// Run the pending task with the highest priority, return 0 if nothing is pending.
+// Scanning starts after the last task run, so equal priorities take turns.
+uint8_t SCHED_dispatch(void) {
+  uint8_t i = SCHED_last;
+  uint8_t best = SCHED_NONE;
+  uint8_t n, events;
+  for(n = SCHED_count; n; n--) {
+    if(++i >= SCHED_count) i = 0;
+    if(SCHED_slot[i].events && ((best == SCHED_NONE) || (SCHED_slot[i].prio > SCHED_slot[best].prio)))
+      best = i;
+  }
+  if(best == SCHED_NONE) return 0;
+  SCHED_lock();
+  events = SCHED_slot[best].events;               // fetch and clear event flags
+  SCHED_slot[best].events = 0;
+  SCHED_unlock();
+  SCHED_last = best;
+  SCHED_slot[best].task(events);
+  return 1;
+}
+
+// Check if any task is pending
+static uint8_t SCHED_pending(void) {
+  uint8_t i;
+  for(i = 0; i < SCHED_count; i++) if(SCHED_slot[i].events) return 1;
+  return 0;
+}
+
+// Run scheduler forever
+void SCHED_run(void) {
+  while(1) {
+    if(SCHED_dispatch()) continue;
+    SCHED_lock();                                 // no event may slip in between
+    if(!SCHED_pending() && SCHED_idleHook) SCHED_idleHook();
+    SCHED_unlock();                               // serve interrupt that woke us up
+  }
+}
+
+// Set function to be called when no task is pending
+void SCHED_setIdleHook(void (*hook)(void)) {
+  SCHED_idleHook = hook;
+}
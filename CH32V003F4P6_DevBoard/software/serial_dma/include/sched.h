@@ -0,0 +1,54 @@
+// ===================================================================================
+// Cooperative Run-to-Completion Task Scheduler for CH32V003                  * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// SCHED_init()             Init scheduler (remove all tasks, set idle hook to sleep)
+// SCHED_add(task, prio)    Add task function with priority (higher value runs first),
+//                          returns task ID or SCHED_NONE if no task slot is free
+// SCHED_post(id, events)   Set event flags of task id (can be called from interrupts)
+// SCHED_dispatch()         Run one pending task, returns 0 if no task was pending
+// SCHED_run()              Run scheduler forever (does not return)
+// SCHED_setIdleHook(f)     Set function to be called when no task is pending
+//
+// A task is a function void task(uint8_t events), which is called with the event
+// flags posted to it since its last run (the flags are cleared before the call).
+// Tasks run to completion, i.e. they must not block, but return quickly and let the
+// next event (e.g. from a timer callback or a driver interrupt) bring them back.
+// Of all tasks with pending events the one with the highest priority runs first,
+// tasks with the same priority take turns (round-robin).
+//
+// If no task is pending, the idle hook is called with interrupts disabled, so that
+// no event can get lost between the check and going to sleep. Pending interrupts
+// still wake up the core from WFI and are served after the idle hook returns. The
+// default idle hook is SLEEP_WFI_now().
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// Scheduler parameters
+#define SCHED_MAX         8                 // max number of tasks (max 254)
+#define SCHED_NONE        0xFF              // invalid task ID
+
+// Task function type
+typedef void (*SCHED_TASK_t)(uint8_t events);
+
+// Scheduler functions
+void SCHED_init(void);                                    // init scheduler
+uint8_t SCHED_add(SCHED_TASK_t task, uint8_t prio);       // add task
+void SCHED_post(uint8_t id, uint8_t events);              // set event flags of task
+uint8_t SCHED_dispatch(void);                             // run one pending task
+void SCHED_run(void);                                     // run scheduler forever
+void SCHED_setIdleHook(void (*hook)(void));               // set idle function
+
+#ifdef __cplusplus
+};
+#endif
@@ -0,0 +1,132 @@
+// ===================================================================================
+// Tickless Software Timer Service using SysTick Compare for CH32V003         * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "timer.h"
+
+// Timer slot
+typedef struct {
+  void (*callback)(void);                         // function to call on expiry
+  uint32_t deadline;                              // SysTick value of next expiry
+  uint32_t period;                                // period in ticks (0: one-shot)
+  uint8_t  next;                                  // next timer in sorted list
+  uint8_t  active;                                // timer is running
+} TIMER_t;
+
+TIMER_t TIMER_slot[TIMER_MAX];                    // timer slots
+uint8_t TIMER_head;                               // timer with next expiry
+
+// Enter/leave critical section (restores previous interrupt state, usable in ISR)
+#define TIMER_lock()      uint32_t mstatus = __get_MSTATUS(); __disable_irq()
+#define TIMER_unlock()    __set_MSTATUS(mstatus)
+
+// Init timer service
+void TIMER_init(void) {
+  uint8_t i;
+  for(i=0; i<TIMER_MAX; i++) TIMER_slot[i].active = 0;
+  TIMER_head = TIMER_NONE;
+  STK->CTLR  = STK_CTLR_STE                       // enable SysTick (free running)
+             | STK_CTLR_STCLK;                    // set SysTick clock to F_CPU
+  NVIC_EnableIRQ(SysTicK_IRQn);                   // enable the SysTick IRQ
+}
+
+// Insert timer into list sorted by deadline (interrupts must be disabled)
+static void TIMER_insert(uint8_t id) {
+  uint32_t deadline = TIMER_slot[id].deadline;
+  uint8_t* link = &TIMER_head;
+  while((*link != TIMER_NONE) && ((int32_t)(TIMER_slot[*link].deadline - deadline) <= 0))
+    link = &TIMER_slot[*link].next;
+  TIMER_slot[id].next = *link;
+  *link = id;
+}
+
+// Remove timer from list (interrupts must be disabled)
+static void TIMER_remove(uint8_t id) {
+  uint8_t* link = &TIMER_head;
+  while(*link != TIMER_NONE) {
+    if(*link == id) {
+      *link = TIMER_slot[id].next;
+      return;
+    }
+    link = &TIMER_slot[*link].next;
+  }
+}
+
+// Program SysTick compare for next expiry or disable interrupt if no timer is running
+static void TIMER_arm(void) {
+  if(TIMER_head == TIMER_NONE) {
+    STK->CTLR &= ~STK_CTLR_STIE;                  // nothing to do: no interrupts
+    return;
+  }
+  uint32_t deadline = TIMER_slot[TIMER_head].deadline;
+  uint32_t soon     = STK->CNT + TIMER_MARGIN;
+  if((int32_t)(deadline - soon) < 0) deadline = soon; // already due: fire soon
+  STK->CMP   = deadline;
+  STK->SR    = 0;                                 // clear pending compare flag
+  STK->CTLR |= STK_CTLR_STIE;                     // enable compare match interrupt
+}
+
+// Start timer (period 0: one-shot)
+static uint8_t TIMER_add(void (*callback)(void), uint32_t delay, uint32_t period) {
+  uint8_t id;
+  TIMER_lock();
+  for(id=0; id<TIMER_MAX; id++) if(!TIMER_slot[id].active) break;
+  if(id < TIMER_MAX) {
+    TIMER_slot[id].callback = callback;
+    TIMER_slot[id].deadline = STK->CNT + delay * DLY_MS_TIME;
+    TIMER_slot[id].period   = period * DLY_MS_TIME;
+    TIMER_slot[id].active   = 1;
+    TIMER_insert(id);
+    if(TIMER_head == id) TIMER_arm();             // new first timer: reprogram compare
+  }
+  else id = TIMER_NONE;
+  TIMER_unlock();
+  return id;
+}
+
+// Start periodic timer
+uint8_t TIMER_start(void (*callback)(void), uint32_t period) {
+  return TIMER_add(callback, period, period);
+}
+
+// Start one-shot timer
+uint8_t TIMER_once(void (*callback)(void), uint32_t delay) {
+  return TIMER_add(callback, delay, 0);
+}
+
+// Cancel timer
+void TIMER_cancel(uint8_t id) {
+  if(id >= TIMER_MAX) return;
+  TIMER_lock();
+  if(TIMER_slot[id].active) {
+    TIMER_slot[id].active = 0;
+    TIMER_remove(id);
+    TIMER_arm();
+  }
+  TIMER_unlock();
+}
+
+// Check if timer is running
+uint8_t TIMER_active(uint8_t id) {
+  return((id < TIMER_MAX) && TIMER_slot[id].active);
+}
+
+// SysTick compare interrupt: call all expired timers, then program next expiry
+void SysTick_Handler(void) __attribute__((interrupt));
+void SysTick_Handler(void) {
+  STK->SR = 0;                                    // clear interrupt flag
+  while((TIMER_head != TIMER_NONE)
+     && ((int32_t)(TIMER_slot[TIMER_head].deadline - STK->CNT) <= 0)) {
+    uint8_t  id = TIMER_head;
+    TIMER_t* t  = &TIMER_slot[id];
+    TIMER_head  = t->next;                        // take timer from list
+    if(t->period) {                               // periodic timer?
+      t->deadline += t->period;                   // next expiry without drift
+      TIMER_insert(id);                           // put back into list
+    }
+    else t->active = 0;                           // one-shot timer is done
+    t->callback();                                // call timer function
+  }
+  TIMER_arm();                                    // program next expiry
+}
@@ -0,0 +1,50 @@
+// ===================================================================================
+// Tickless Software Timer Service using SysTick Compare for CH32V003         * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// TIMER_init()             Init timer service (SysTick keeps running for DLY functions)
+// TIMER_start(cb, p)       Start periodic timer calling cb every p milliseconds,
+//                          returns timer ID or TIMER_NONE if no timer slot is free
+// TIMER_once(cb, d)        Start one-shot timer calling cb after d milliseconds,
+//                          returns timer ID or TIMER_NONE if no timer slot is free
+// TIMER_cancel(id)         Cancel timer with ID id
+// TIMER_active(id)         Check if timer with ID id is running
+//
+// SysTick runs freely at F_CPU. The timers are kept in a list sorted by expiry time
+// and STK->CMP is only programmed for the next expiry. No interrupt occurs as long as
+// no timer is due, so the main loop can simply call SLEEP_WFI_now() whenever it has
+// nothing else to do. Periodic timers are rescheduled relative to their last expiry
+// time, so they don't drift. Maximum period is 2^31 ticks (89 seconds @ 24 MHz).
+//
+// The callbacks are called from the SysTick interrupt, so keep them short (e.g. set
+// a flag). They may start and cancel timers, including their own.
+// SYS_USE_VECTORS in system.h must be set to 1, since the SysTick interrupt is used.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// Timer parameters
+#define TIMER_MAX         8                 // max number of timers (max 254)
+#define TIMER_MARGIN      64                // min ticks between now and next compare
+
+#define TIMER_NONE        0xFF              // invalid timer ID
+
+// Timer functions
+void TIMER_init(void);                                    // init timer service
+uint8_t TIMER_start(void (*callback)(void), uint32_t period); // start periodic timer
+uint8_t TIMER_once(void (*callback)(void), uint32_t delay);   // start one-shot timer
+void TIMER_cancel(uint8_t id);                            // cancel timer
+uint8_t TIMER_active(uint8_t id);                         // check if timer is running
+
+#ifdef __cplusplus
+};
+#endif
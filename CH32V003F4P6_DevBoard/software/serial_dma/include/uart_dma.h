@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA RX Buffer for CH32V003                                       * v1.1 *
+// UART with DMA RX/TX Buffer for CH32V003                                    * v1.9 *
 // ===================================================================================
 //
 // Functions available:
@@ -12,12 +12,28 @@
 // UART_setOddParity()      Set parity bit, odd
 // UART_setEvenParity()     Set parity bit, even
 //
-// UART_ready()             Check if UART is ready to write
+// UART_ready()             Check if UART is ready to write (TX buffer not full)
 // UART_available()         Check if there is something to read
 // UART_completed()         Check if transmission is completed
 //
 // UART_read()              Read character via UART
-// UART_write(c)            Send character via UART
+// UART_peek()              Get next character without removing it from RX buffer
+// UART_rxSpans(s)          Get filled regions of RX buffer (zero-copy), returns count
+// UART_consume(n)          Remove n bytes from RX buffer (after UART_rxSpans)
+//
+// UART_write(c)            Send character via UART (buffered, non-blocking)
+// UART_writeBuffer(p,n)    Send n bytes from buffer p via UART (buffered)
+// UART_txFree()            Get number of free bytes in TX buffer
+// UART_flush()             Wait until all buffered bytes are transmitted
+//
+// If event-driven receive is activated (see below):
+// UART_getFrame(f)         Get and clear received frame info, returns events (0: none)
+// UART_frameReady()        Check if a new frame was received
+// UART_setFrameCallback(f) Set function to be called on each frame (from interrupt)
+//
+// If RX statistics are activated (see below):
+// UART_getStats(s)         Copy RX statistics into stats struct s
+// UART_clearStats()        Reset RX statistics (except total number of received bytes)
 //
 // UART_enable()            Enable USART
 // UART_disable()           Disable USART
@@ -26,8 +42,11 @@
 // UART_RX_enable()         Enable receiver
 // UART_RX_disable()        Disable receiver
 //
-// If print functions are activated (see below, print.h must be included):
+// If print functions are activated (see below, print.h must be included), they hand
+// complete strings to UART_writeBuffer (block-write sink), i.e. one DMA-ring copy:
 // UART_printD(n)           Print decimal value
+// UART_printI(n)           Print signed decimal value
+// UART_printF(n,d)         Print fixed-point value n with d decimals
 // UART_printW(n)           Print 32-bit hex word value
 // UART_printH(n)           Print 16-bit hex half-word value
 // UART_printB(n)           Print  8-bit hex byte value
@@ -42,6 +61,27 @@
 // TX-pin    PD5   PD0   PD6   PC0
 // RX-pin    PD6   PD1   PD5   PC1
 //
+// Notes:
+// ------
+// - Received bytes are written by DMA channel 5 into a circular RX buffer.
+// - If UART_TX_DMA is set, bytes to send are put into a TX queue (lock-free SPSC
+//   queue, see spsc.h), which is drained in the background by DMA channel 4. Each
+//   transfer-complete interrupt starts the next contiguous chunk of the queue.
+//   UART_write() only blocks if the TX queue is full. Otherwise, each byte is written
+//   directly into the USART data register (polled, no TX buffer and no interrupt),
+//   which is smaller and sufficient for short replies.
+// - If UART_RX_FRAMES is set, the USART IDLE interrupt and the DMA half- and full-
+//   transfer interrupts report received bytes as frames (offset and length in RX
+//   buffer). The IDLE interrupt fires one character time after the end of a burst.
+//   Frames stay in the RX buffer until they are removed with UART_consume().
+// - If UART_RX_STATS is set, DMA laps are counted in the transfer-complete interrupt.
+//   Together with the DMA counter, this gives the total number of received bytes,
+//   so RX buffer overflows (the DMA lapping unread data) are detected on the next
+//   read. On overflow, the RX buffer is discarded and the lost bytes are counted.
+//   Peak occupancy and USART errors are recorded to help size UART_RX_BUF_SIZE.
+// - SYS_USE_VECTORS in system.h must be set to 1 if UART_TX_DMA, UART_RX_FRAMES or
+//   UART_RX_STATS is set, since interrupts are used then.
+//
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #pragma once
@@ -50,16 +90,20 @@
 extern "C" {
 #endif
 
-#include "ch32v003.h"
+#include "system.h"
 
 // UART Parameters
 #define UART_BAUD             115200      // default UART baud rate
 #define UART_MAP              0           // UART pin mapping (see above)
-#define UART_RX_BUF_SIZE      64          // UART RX buffer size
-#define UART_PRINT            0           // 1: include print functions (needs print.h)
+#define UART_RX_BUF_SIZE      64          // UART RX buffer size (max 65535)
+#define UART_TX_DMA           1           // 1: send via DMA TX queue, 0: polled TX
+#define UART_TX_BUF_SIZE      128         // UART TX buffer size (power of 2)
+#define UART_RX_FRAMES        1           // 1: event-driven receive (IDLE/HT/TC IRQ)
+#define UART_RX_STATS         0           // 1: RX overflow detection and statistics
+#define UART_PRINT            1           // 1: include print functions (needs print.h)
 
 // UART Macros
-#define UART_ready()          (USART1->STATR & USART_STATR_TXE)   // ready to write
+#define UART_ready()          (UART_txFree() > 0)                 // ready to write
 #define UART_completed()      (USART1->STATR & USART_STATR_TC)    // transmission completed
 
 #define UART_enable()         USART1->CTLR1 |= USART_CTLR1_UE     // enable USART
@@ -76,23 +120,74 @@ extern "C" {
 #define UART_setOddParity()   {USART1->CTLR1 |= USART_CTLR1_PCE; USART1->CTLR1 |=  USART_CTLR1_PS;}
 #define UART_setNoParity()    USART1->CTLR1 &= ~USART_CTLR1_PCE
 
+// UART RX span, one or two contiguous filled regions of the circular RX buffer
+typedef struct {
+  char*    data1;                         // first region (oldest bytes)
+  uint16_t len1;                          // length of first region
+  char*    data2;                         // second region (wrapped around, if any)
+  uint16_t len2;                          // length of second region
+} UART_SPAN_t;
+
 // UART Functions
 void UART_init(void);                     // init UART with default BAUD rate
 void UART_write(const char c);            // send character via UART
+void UART_writeBuffer(const char* buf, uint16_t len); // send buffer via UART
+uint16_t UART_txFree(void);               // get number of free bytes in TX buffer
+void UART_flush(void);                    // wait until TX buffer is sent
 char UART_read(void);                     // read character via UART
+char UART_peek(void);                     // get next character without removing it
+uint16_t UART_rxSpans(UART_SPAN_t* span); // get filled regions of RX buffer
+void UART_consume(uint16_t n);            // remove n bytes from RX buffer
 uint8_t UART_available(void);             // check if there is something to read
 
+// Event-driven receive (if activated, see above)
+#if UART_RX_FRAMES == 1
+#define UART_EVT_IDLE         0x01        // frame ended by idle line
+#define UART_EVT_HALF         0x02        // RX buffer half full (DMA half-transfer)
+#define UART_EVT_FULL         0x04        // RX buffer full (DMA transfer complete)
+
+// UART RX frame, received bytes in RX buffer since last frame
+typedef struct {
+  uint16_t offset;                        // position of first byte in RX buffer
+  uint16_t len;                           // number of bytes
+  uint8_t  events;                        // events which ended the frame (see above)
+} UART_FRAME_t;
+
+extern volatile UART_FRAME_t UART_frame;
+#define UART_frameReady()     (UART_frame.events)                 // new frame received
+uint8_t UART_getFrame(UART_FRAME_t* frame);                       // get and clear frame
+void UART_setFrameCallback(void (*callback)(UART_FRAME_t* frame)); // set frame callback
+#endif
+
+// RX statistics (if activated, see above)
+#if UART_RX_STATS == 1
+typedef struct {
+  uint32_t received;                      // total number of received bytes
+  uint32_t lost;                          // number of bytes lost by overflows
+  uint16_t overflows;                     // number of RX buffer overflows
+  uint16_t peak;                          // highest RX buffer occupancy (watermark)
+  uint16_t overruns;                      // USART overrun errors (ORE)
+  uint16_t framing;                       // USART framing errors (FE)
+  uint16_t noise;                         // USART noise errors (NE)
+} UART_STATS_t;
+
+void UART_getStats(UART_STATS_t* stats);  // copy RX statistics
+void UART_clearStats(void);               // reset RX statistics
+#endif
+
 // Additional print functions (if activated, see above)
 #if UART_PRINT == 1
 #include "print.h"
-#define UART_printD(n)    printD(n, UART_write)   // print decimal as string
-#define UART_printW(n)    printW(n, UART_write)   // print word as string
-#define UART_printH(n)    printH(n, UART_write)   // print half-word as string
-#define UART_printB(n)    printB(n, UART_write)   // print byte as string
-#define UART_printS(s)    printS(s, UART_write)   // print string
-#define UART_println(s)   println(s, UART_write)  // print string with newline
-#define UART_print        UART_printS             // alias
-#define UART_newline()    UART_write('\n')        // send newline
+#define UART_printD(n)    writeD(n, UART_writeBuffer)     // print decimal as string
+#define UART_printI(n)    writeI(n, UART_writeBuffer)     // print signed decimal
+#define UART_printF(n,d)  writeF(n, d, UART_writeBuffer)  // print fixed-point value
+#define UART_printW(n)    writeW(n, UART_writeBuffer)     // print word as string
+#define UART_printH(n)    writeH(n, UART_writeBuffer)     // print half-word as string
+#define UART_printB(n)    writeB(n, UART_writeBuffer)     // print byte as string
+#define UART_printS(s)    writeS(s, UART_writeBuffer)     // print string
+#define UART_println(s)   writeln(s, UART_writeBuffer)    // print string with newline
+#define UART_print        UART_printS                     // alias
+#define UART_newline()    UART_write('\n')                // send newline
 #endif
 
 #ifdef __cplusplus
@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   UART DMA Serial Demo for CH32V003
-// Version:   v1.0
+// Version:   v1.3
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,7 +10,14 @@
 //
 // Description:
 // ------------
-// Echoes data sent via UART. Uses DMA for UART RX.
+// Echoes data sent via UART while blinking the built-in LED. Uses DMA for UART RX
+// and TX. Both jobs run as tasks of the cooperative scheduler: the UART frame
+// interrupt posts an event to the echo task, the software timer posts an event to
+// the LED task, and the MCU sleeps whenever no task is pending. On startup, a short
+// benchmark is run, which sends a number of text lines via the DMA TX ring buffer and
+// reports throughput, time needed to enqueue one line and CPU load while sending.
+// If PROF_ENABLE is set to 1 in prof.h, the cycle statistics of the profiling probes
+// in the UART driver are printed after the benchmark.
 //
 // References:
 // -----------
@@ -29,17 +36,102 @@
 // Libraries, Definitions and Macros
 // ===================================================================================
 #include <system.h>           // system functions
+#include <gpio.h>             // GPIO functions
 #include <uart_dma.h>         // UART functions
+#include <timer.h>            // software timer functions
+#include <sched.h>            // task scheduler
+#include <prof.h>             // profiling probes
+
+#define PIN_LED       PC0                         // define LED pin
+#define EVT_RX        0x01                        // event: UART frame received
+#define EVT_TICK      0x01                        // event: timer tick
+
+#define BENCH_LINE    "The quick brown fox jumps over the lazy dog 0123456789\n"
+#define BENCH_LEN     (sizeof(BENCH_LINE) - 1)    // length of one line
+#define BENCH_LINES   16                          // number of lines to send
+
+// ===================================================================================
+// UART TX Benchmark
+// ===================================================================================
+void BENCH_run(void) {
+  uint32_t start, stamp, total;
+  uint32_t busy = 0, maxline = 0;
+  uint8_t  i;
+
+  UART_println("UART DMA TX Benchmark");
+  UART_flush();
+  start = STK->CNT;
+  for(i = 0; i < BENCH_LINES; i++) {
+    while(UART_txFree() < BENCH_LEN);             // CPU is free for other work here
+    stamp = STK->CNT;
+    UART_writeBuffer(BENCH_LINE, BENCH_LEN);      // enqueue one line
+    stamp = STK->CNT - stamp;
+    busy += stamp;
+    if(stamp > maxline) maxline = stamp;
+  }
+  UART_flush();
+  total = STK->CNT - start;
+
+  UART_print("Bytes sent:         "); UART_printD(BENCH_LEN * BENCH_LINES);     UART_newline();
+  UART_print("Total time (us):    "); UART_printD(total / DLY_US_TIME);         UART_newline();
+  UART_print("Throughput (B/s):   ");
+  UART_printD(BENCH_LEN * BENCH_LINES * 1000000 / (total / DLY_US_TIME));      UART_newline();
+  UART_print("Enqueue line (us):  "); UART_printD(maxline / DLY_US_TIME);       UART_newline();
+  UART_print("Blocking line (us): "); UART_printD(BENCH_LEN * 10 * 1000000 / UART_BAUD);
+  UART_newline();
+  UART_print("CPU busy (%):       "); UART_printD(busy * 100 / total);          UART_newline();
+}
+
+// ===================================================================================
+// Tasks (called by scheduler)
+// ===================================================================================
+uint8_t TASK_echo;                                // echo task ID
+uint8_t TASK_led;                                 // LED task ID
+
+// Echo everything in RX buffer
+void ECHO_task(uint8_t events) {
+  UART_SPAN_t span;
+  uint16_t len = UART_rxSpans(&span);             // get received data in place
+  UART_writeBuffer(span.data1, span.len1);        // echo first part
+  UART_writeBuffer(span.data2, span.len2);        // echo wrapped part
+  UART_consume(len);                              // release data in RX buffer
+}
+
+// Toggle LED
+void LED_task(uint8_t events) {
+  PIN_toggle(PIN_LED);
+}
+
+// ===================================================================================
+// Event Sources (called from interrupts)
+// ===================================================================================
+void ECHO_frame(UART_FRAME_t* frame) {
+  SCHED_post(TASK_echo, EVT_RX);
+}
+
+void LED_tick(void) {
+  SCHED_post(TASK_led, EVT_TICK);
+}
 
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
   // Setup
+  PIN_output(PIN_LED);        // set LED pin as output
   UART_init();                // init UART with default BAUD rate (115200)
-  
+  PROF_init();                // init profiling probes
+  BENCH_run();                // run TX benchmark
+  PROF_dump(UART_writeBuffer);// print probe statistics
+
+  // Setup tasks and event sources
+  SCHED_init();                                   // init scheduler
+  TASK_echo = SCHED_add(ECHO_task, 1);            // echo has priority over LED
+  TASK_led  = SCHED_add(LED_task,  0);
+  UART_setFrameCallback(ECHO_frame);              // post event on each UART frame
+  TIMER_init();                                   // init software timer service
+  TIMER_start(LED_tick, 500);                     // post event every 500ms
+
   // Loop
-  while(1) {
-    UART_write(UART_read());  // echo any received character
-  }
+  SCHED_run();                                    // run tasks, sleep when idle
 }
@@ -0,0 +1,136 @@
+// ===================================================================================
+// Host Benchmark and Test for Number Formatting (print.c)
+// ===================================================================================
+//
+// Compares the reciprocal/lookup-table decimal conversion of print.c against the
+// original subtraction method and verifies all formatting functions against snprintf.
+// Runs on the host PC, build with either division method:
+//
+//   gcc -O2 -I../include -DFMT_MULDIV=0 printbench.c ../include/print.c -o printbench
+//   gcc -O2 -I../include -DFMT_MULDIV=1 printbench.c ../include/print.c -o printbench
+//
+// Absolute numbers are host numbers; the ratio between the methods is what matters.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "print.h"
+
+#define ROUNDS  2000000
+
+// Original subtraction method (print.c v1.0)
+static const uint32_t DIVIDER[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                                   10000000, 100000000, 1000000000};
+
+static char  *outptr;
+static void  putbuf(char c) {*outptr++ = c;}
+
+static void legacyD(uint32_t value, void (*putchar) (char c)) {
+  uint8_t digits   = 10;
+  uint8_t leadflag = 0;
+  while(digits--) {
+    uint8_t digitval = 0;
+    uint32_t divider = DIVIDER[digits];
+    while(value >= divider) {
+      leadflag = 1;
+      digitval++;
+      value -= divider;
+    }
+    if(!digits)  leadflag++;
+    if(leadflag) putchar(digitval + '0');
+  }
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t rnd(void) {
+  static uint32_t x = 0x12345678;
+  x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+  return x;
+}
+
+static int fail(const char* what, const char* got, const char* exp) {
+  printf("FAIL %s: got \"%s\", expected \"%s\"\n", what, got, exp);
+  return 1;
+}
+
+static int verify(void) {
+  char buf[32], ref[32];
+  int  errors = 0;
+  uint32_t v;
+
+  // Exhaustive for small values, random and edge cases for the rest
+  for(v = 0; v < 1000000 && errors < 10; v++) {
+    fmtU(buf, v, 0, 0); sprintf(ref, "%u", v);
+    if(strcmp(buf, ref)) errors += fail("fmtU", buf, ref);
+  }
+  for(int i = 0; i < 10000000 && errors < 10; i++) {
+    v = rnd() >> (rnd() & 31);
+    fmtU(buf, v, 0, 0); sprintf(ref, "%u", v);
+    if(strcmp(buf, ref)) errors += fail("fmtU", buf, ref);
+    fmtI(buf, (int32_t)v, 8, FMT_ZERO); sprintf(ref, "%08d", (int32_t)v);
+    if(strcmp(buf, ref)) errors += fail("fmtI", buf, ref);
+    fmtX(buf, v, 8); sprintf(ref, "%08X", v);
+    if(strcmp(buf, ref)) errors += fail("fmtX", buf, ref);
+    outptr = buf; legacyD(v, putbuf); *outptr = 0; sprintf(ref, "%u", v);
+    if(strcmp(buf, ref)) errors += fail("legacy", buf, ref);
+  }
+  uint32_t edge[] = {9, 10, 99, 100, 999, 1000, 4294967295UL, 4294967200UL, 1000000000UL};
+  for(unsigned i = 0; i < sizeof(edge) / sizeof(edge[0]); i++) {
+    fmtU(buf, edge[i], 12, 0); sprintf(ref, "%12u", edge[i]);
+    if(strcmp(buf, ref)) errors += fail("fmtU width", buf, ref);
+  }
+
+  // Signed and fixed-point
+  int32_t sv[] = {0, 1, -1, 5, -5, 42, -42, 3301, -3301, 100000, 2147483647, -2147483647 - 1};
+  for(unsigned i = 0; i < sizeof(sv) / sizeof(sv[0]); i++) {
+    fmtI(buf, sv[i], 6, 0); sprintf(ref, "%6d", sv[i]);
+    if(strcmp(buf, ref)) errors += fail("fmtI", buf, ref);
+    for(uint8_t d = 0; d <= 9; d++) {
+      int64_t  s = sv[i], p = 1;
+      for(uint8_t k = 0; k < d; k++) p *= 10;
+      int64_t  m = s < 0 ? -s : s;
+      if(d) sprintf(ref, "%s%lld.%0*lld", s < 0 ? "-" : "", (long long)(m / p), d, (long long)(m % p));
+      else  sprintf(ref, "%lld", (long long)s);
+      fmtF(buf, sv[i], d, 0, 0);
+      if(strcmp(buf, ref)) errors += fail("fmtF", buf, ref);
+    }
+  }
+  fmtF(buf, -5, 2, 7, FMT_ZERO);
+  if(strcmp(buf, "-000.05")) errors += fail("fmtF pad", buf, "-000.05");
+  return errors;
+}
+
+int main(void) {
+  static uint32_t values[4096];
+  char buf[32];
+  volatile uint32_t sink = 0;
+  double t0, t1, t2;
+
+  if(verify()) return 1;
+  printf("Formatting results verified against snprintf (FMT_MULDIV=%d)\n", FMT_MULDIV);
+
+  for(int i = 0; i < 4096; i++) values[i] = rnd() >> (rnd() & 31);
+
+  t0 = now();
+  for(int i = 0; i < ROUNDS; i++) {
+    outptr = buf; legacyD(values[i & 4095], putbuf); sink += buf[0];
+  }
+  t1 = now();
+  for(int i = 0; i < ROUNDS; i++) {
+    sink += fmtU(buf, values[i & 4095], 0, 0) + buf[0];
+  }
+  t2 = now();
+
+  printf("Subtraction printD: %6.1f ns/value\n", (t1 - t0) / ROUNDS);
+  printf("fmtU:               %6.1f ns/value\n", (t2 - t1) / ROUNDS);
+  printf("Speedup:            %6.1fx\n", (t1 - t0) / (t2 - t1));
+  return 0;
+}
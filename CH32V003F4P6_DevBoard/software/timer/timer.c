@@ -0,0 +1,58 @@
+// ===================================================================================
+// Project:   Software Timer Demo for CH32V003
+// Version:   v1.0
+// Year:      2023
+// Author:    Stefan Wagner
+// Github:    https://github.com/wagiminator
+// EasyEDA:   https://easyeda.com/wagiminator
+// License:   http://creativecommons.org/licenses/by-sa/3.0/
+// ===================================================================================
+//
+// Description:
+// ------------
+// Blink built-in LED using the tickless software timer service. SysTick only fires
+// when a timer is due (instead of every millisecond), the core sleeps in between.
+//
+// References:
+// -----------
+// - CNLohr ch32v003fun: https://github.com/cnlohr/ch32v003fun
+// - WCH Nanjing Qinheng Microelectronics: http://wch.cn
+//
+// Compilation Instructions:
+// -------------------------
+// - Make sure GCC toolchain (gcc-riscv64-unknown-elf, newlib) and Python3 with PyUSB
+//   is installed. In addition, Linux requires access rights to WCH-LinkE programmer.
+// - Connect the WCH-LinkE programmer to the MCU board.
+// - Run 'make flash'.
+
+
+// ===================================================================================
+// Libraries, Definitions and Macros
+// ===================================================================================
+#include <system.h>                 // system functions
+#include <gpio.h>                   // GPIO functions
+#include <timer.h>                  // software timer functions
+
+#define PIN_LED   PC0               // define LED pin
+
+// ===================================================================================
+// Timer Callbacks (called from SysTick interrupt)
+// ===================================================================================
+void LED_toggle(void) {
+  PIN_toggle(PIN_LED);              // toggle LED on/off
+}
+
+// ===================================================================================
+// Main Function
+// ===================================================================================
+int main(void) {
+  // Setup
+  PIN_output(PIN_LED);              // set LED pin as output
+  TIMER_init();                     // init software timer service
+  TIMER_start(LED_toggle, 100);     // toggle LED every 100 milliseconds
+  
+  // Loop
+  while(1) {
+    SLEEP_WFI_now();                // sleep until next timer expires
+  }
+}
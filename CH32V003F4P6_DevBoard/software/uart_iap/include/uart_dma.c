@@ -0,0 +1,403 @@
+// ===================================================================================
+// UART with DMA RX/TX Buffer for CH32V003                                    * v1.9 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "uart_dma.h"
+#include "prof.h"
+#if UART_TX_DMA == 1
+#include "spsc.h"
+#endif
+
+// Circular RX buffer
+char UART_RX_buffer[UART_RX_BUF_SIZE];
+uint16_t UART_RX_tptr = 0;
+#define UART_RX_hptr (UART_RX_BUF_SIZE - DMA1_Channel5->CNTR)
+#define UART_RX_IRQ  (UART_RX_FRAMES == 1 || UART_RX_STATS == 1)
+
+// TX queue (producer: UART_write, consumer: DMA interrupt)
+#if UART_TX_DMA == 1
+SPSC_define(UART_TX, char, UART_TX_BUF_SIZE);
+volatile uint16_t UART_TX_len  = 0;           // length of running DMA transfer (0: idle)
+#endif
+
+// RX frame state
+#if UART_RX_FRAMES == 1
+volatile UART_FRAME_t UART_frame;             // pending frame (merged if not fetched)
+volatile uint16_t UART_RX_fptr = 0;           // end of last reported frame
+void (*UART_frameCallback)(UART_FRAME_t* frame) = 0;
+#endif
+
+// RX statistics
+#if UART_RX_STATS == 1
+volatile UART_STATS_t UART_stats;             // statistics
+volatile uint32_t UART_RX_laps = 0;           // number of completed DMA laps
+volatile uint32_t UART_RX_rpos = 0;           // total number of consumed bytes
+#endif
+
+// Init UART
+void UART_init(void) {
+#if UART_MAP == 0
+  // Enable GPIO port D and UART
+  RCC->APB2PCENR |= RCC_AFIOEN | RCC_IOPDEN | RCC_USART1EN;
+
+  // Set pin PD5 (TX) to output, push-pull, 10MHz, multiplex
+  // Set pin PD6 (RX) to input, pullup
+  GPIOD->CFGLR  = (GPIOD->CFGLR & ~(((uint32_t)0b1111<<(5<<2)) | ((uint32_t)0b1111<<(6<<2))))
+                                |  (((uint32_t)0b1001<<(5<<2)) | ((uint32_t)0b1000<<(6<<2)));
+  GPIOD->OUTDR |= 1<<6;
+#elif UART_MAP == 1
+  // Remap UART pins, enable GPIO port D and UART
+  RCC->APB2PCENR |= RCC_AFIOEN | RCC_IOPDEN | RCC_USART1EN;
+  AFIO->PCFR1    |= 1<<2;
+  
+  // Set pin PD0 (TX) to output, push-pull, 10MHz, multiplex
+  // Set pin PD1 (RX) to input, pullup
+  GPIOD->CFGLR  = (GPIOD->CFGLR & ~(((uint32_t)0b1111<<(0<<2)) | ((uint32_t)0b1111<<(1<<2))))
+                                |  (((uint32_t)0b1001<<(0<<2)) | ((uint32_t)0b1000<<(1<<2)));
+  GPIOD->OUTDR |= 1<<1;
+#elif UART_MAP == 2
+  // Remap UART pins, enable GPIO port D and UART
+  RCC->APB2PCENR |= RCC_AFIOEN | RCC_IOPDEN | RCC_USART1EN;
+  AFIO->PCFR1    |= 1<<21;
+
+  // Set pin PD6 (TX) to output, push-pull, 10MHz, multiplex
+  // Set pin PD5 (RX) to input, pullup
+  GPIOD->CFGLR  = (GPIOD->CFGLR & ~(((uint32_t)0b1111<<(6<<2)) | ((uint32_t)0b1111<<(5<<2))))
+                                |  (((uint32_t)0b1001<<(6<<2)) | ((uint32_t)0b1000<<(5<<2)));
+  GPIOD->OUTDR |= 1<<5;
+#elif UART_MAP == 3
+  // Remap UART pins, enable GPIO port C and UART
+  RCC->APB2PCENR |= RCC_AFIOEN | RCC_IOPCEN | RCC_USART1EN;
+  AFIO->PCFR1    |= (1<<21) | (1<<2);
+
+  // Set pin PC0 (TX) to output, push-pull, 10MHz, multiplex
+  // Set pin PC1 (RX) to input, pullup
+  GPIOC->CFGLR  = (GPIOC->CFGLR & ~(((uint32_t)0b1111<<(0<<2)) | ((uint32_t)0b1111<<(1<<2))))
+                                |  (((uint32_t)0b1001<<(0<<2)) | ((uint32_t)0b1000<<(1<<2)));
+  GPIOC->OUTDR |= 1<<1;
+#else
+  #warning Wrong UART REMAP
+#endif
+	
+  // Setup and start UART (8N1, RX/TX, default BAUD rate)
+  USART1->BRR    = ((2 * F_CPU / UART_BAUD) + 1) / 2;
+  USART1->CTLR3 |= USART_CTLR3_DMAR;
+  USART1->CTLR1  = USART_CTLR1_RE | USART_CTLR1_TE | USART_CTLR1_UE;
+
+  // Setup DMA Channel 5
+  RCC->AHBPCENR |= RCC_DMA1EN;
+  DMA1_Channel5->CNTR  = (uint16_t)UART_RX_BUF_SIZE;
+  DMA1_Channel5->MADDR = (uint32_t)UART_RX_buffer;
+  DMA1_Channel5->PADDR = (uint32_t)&USART1->DATAR;
+  DMA1_Channel5->CFGR  = DMA_CFGR1_MINC       // increment memory address
+                       | DMA_CFGR1_CIRC       // circular mode
+                       #if UART_RX_FRAMES == 1
+                       | DMA_CFGR1_HTIE       // half transfer interrupt enable
+                       #endif
+                       #if UART_RX_IRQ
+                       | DMA_CFGR1_TCIE       // transfer complete interrupt enable
+                       #endif
+                       | DMA_CFGR1_EN;        // enable
+
+  // Setup idle line and error detection
+  #if UART_RX_FRAMES == 1
+  USART1->CTLR1 |= USART_CTLR1_IDLEIE;        // enable IDLE interrupt
+  #endif
+  #if UART_RX_STATS == 1
+  USART1->CTLR3 |= USART_CTLR3_EIE;           // enable error interrupt
+  #endif
+  #if UART_RX_IRQ
+  NVIC_EnableIRQ(USART1_IRQn);                // enable USART interrupt
+  NVIC_EnableIRQ(DMA1_Channel5_IRQn);         // enable DMA channel 5 interrupt
+  #endif
+
+  // Setup DMA Channel 4
+  #if UART_TX_DMA == 1
+  SPSC_reset(UART_TX);                        // empty TX queue
+  UART_TX_len = 0;
+  DMA1_Channel4->PADDR = (uint32_t)&USART1->DATAR;
+  DMA1_Channel4->CFGR  = DMA_CFGR1_MINC       // increment memory address
+                       | DMA_CFGR1_DIR        // memory to peripheral
+                       | DMA_CFGR1_TCIE;      // transfer complete interrupt enable
+  USART1->CTLR3 |= USART_CTLR3_DMAT;          // enable TX DMA request
+  NVIC_EnableIRQ(DMA1_Channel4_IRQn);         // enable DMA channel 4 interrupt
+  #endif
+}
+
+#if UART_RX_STATS == 1
+// Get total number of received bytes (DMA laps plus DMA counter)
+uint32_t UART_RX_received(void) {
+  uint32_t laps;
+  uint16_t head;
+  uint8_t  pending;
+  do {
+    laps    = UART_RX_laps;
+    head    = UART_RX_hptr;
+    pending = (DMA1->INTFR & DMA_TCIF5) && (head < UART_RX_BUF_SIZE / 2);
+  } while(laps != UART_RX_laps);              // repeat if DMA interrupt came in between
+  if(pending) laps++;                         // DMA wrapped, but lap is not counted yet
+  return(laps * UART_RX_BUF_SIZE + head);
+}
+
+// Detect RX buffer overflow, discard buffer if so
+void UART_RX_check(void) {
+  uint32_t received = UART_RX_received();
+  uint32_t level    = received - UART_RX_rpos;
+  if(level < UART_RX_BUF_SIZE) return;        // no overflow
+  __disable_irq();
+  UART_stats.overflows++;
+  UART_stats.lost  += level;
+  UART_RX_rpos      = received;               // discard whole buffer
+  UART_RX_tptr      = received % UART_RX_BUF_SIZE;
+  #if UART_RX_FRAMES == 1
+  UART_RX_fptr      = UART_RX_tptr;           // discard pending frame
+  UART_frame.events = 0;
+  #endif
+  __enable_irq();
+}
+#define UART_RX_advance(n)  UART_RX_rpos += (n)
+#else
+#define UART_RX_check()
+#define UART_RX_advance(n)
+#endif
+
+// Check if something is in the RX buffer
+uint8_t UART_available(void) {
+  UART_RX_check();
+  return(UART_RX_hptr != UART_RX_tptr);
+}
+
+// Read from UART buffer
+char UART_read(void) {
+  char result;
+  PROF_BEGIN(PROF_UART_READ);
+  while(!UART_available());
+  result = UART_RX_buffer[UART_RX_tptr++];
+  if(UART_RX_tptr >= UART_RX_BUF_SIZE) UART_RX_tptr = 0;
+  UART_RX_advance(1);
+  PROF_END(PROF_UART_READ);
+  return result;
+}
+
+// Get next character from UART buffer without removing it
+char UART_peek(void) {
+  while(!UART_available());
+  return UART_RX_buffer[UART_RX_tptr];
+}
+
+// Get the one or two contiguous filled regions of the RX buffer, return byte count
+uint16_t UART_rxSpans(UART_SPAN_t* span) {
+  uint16_t head, tail;
+  UART_RX_check();
+  head = UART_RX_hptr;
+  tail = UART_RX_tptr;
+  span->data1 = &UART_RX_buffer[tail];
+  span->data2 = UART_RX_buffer;
+  if(head >= tail) {
+    span->len1 = head - tail;
+    span->len2 = 0;
+  }
+  else {
+    span->len1 = UART_RX_BUF_SIZE - tail;
+    span->len2 = head;
+  }
+  return(span->len1 + span->len2);
+}
+
+// Remove n bytes from RX buffer (n must not exceed count returned by UART_rxSpans)
+void UART_consume(uint16_t n) {
+  uint16_t tail = UART_RX_tptr + n;
+  if(tail >= UART_RX_BUF_SIZE) tail -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = tail;
+  UART_RX_advance(n);
+}
+
+#if UART_RX_FRAMES == 1
+
+// Report bytes received since last frame (called from interrupt)
+void UART_RX_event(uint8_t events) {
+  uint16_t head = UART_RX_hptr;
+  uint16_t fptr = UART_RX_fptr;
+  uint16_t len;
+  if(head == fptr) return;                    // nothing new
+  len = (head > fptr) ? (head - fptr) : (UART_RX_BUF_SIZE - fptr + head);
+  UART_RX_fptr = head;
+  if(UART_frameCallback) {                    // deliver frame via callback
+    UART_FRAME_t frame = {fptr, len, events};
+    UART_frameCallback(&frame);
+    return;
+  }
+  if(!UART_frame.events) {                    // start a new frame
+    UART_frame.offset = fptr;
+    UART_frame.len    = 0;
+  }
+  UART_frame.len    += len;                   // otherwise merge with pending frame
+  UART_frame.events |= events;
+}
+
+// Get and clear received frame info, returns events (0: no new frame)
+uint8_t UART_getFrame(UART_FRAME_t* frame) {
+  __disable_irq();
+  *frame = UART_frame;
+  UART_frame.events = 0;
+  __enable_irq();
+  return frame->events;
+}
+
+// Set function to be called on each received frame (from interrupt context)
+void UART_setFrameCallback(void (*callback)(UART_FRAME_t* frame)) {
+  UART_frameCallback = callback;
+}
+
+#endif  // UART_RX_FRAMES == 1
+
+#if UART_RX_STATS == 1
+// Copy RX statistics
+void UART_getStats(UART_STATS_t* stats) {
+  UART_RX_check();
+  __disable_irq();
+  *stats = UART_stats;
+  __enable_irq();
+  stats->received = UART_RX_received();
+}
+
+// Reset RX statistics
+void UART_clearStats(void) {
+  __disable_irq();
+  UART_stats.lost      = 0;
+  UART_stats.overflows = 0;
+  UART_stats.peak      = 0;
+  UART_stats.overruns  = 0;
+  UART_stats.framing   = 0;
+  UART_stats.noise     = 0;
+  __enable_irq();
+}
+
+// Update RX buffer watermark (called from interrupt)
+void UART_RX_watermark(void) {
+  uint32_t level = UART_RX_received() - UART_RX_rpos;
+  if(level > UART_stats.peak) UART_stats.peak = level;
+}
+#endif  // UART_RX_STATS == 1
+
+#if UART_RX_IRQ
+// USART interrupt service routine: idle line or error detected
+void USART1_IRQHandler(void) __attribute__((interrupt));
+void USART1_IRQHandler(void) {
+  uint16_t status = USART1->STATR;
+  PROF_BEGIN(PROF_UART_IRQ);
+  if(status & (USART_STATR_ORE | USART_STATR_FE | USART_STATR_NE | USART_STATR_IDLE))
+    (void)USART1->DATAR;                      // clear flags (read STATR, then DATAR)
+  #if UART_RX_STATS == 1
+  if(status & USART_STATR_ORE) UART_stats.overruns++;
+  if(status & USART_STATR_FE)  UART_stats.framing++;
+  if(status & USART_STATR_NE)  UART_stats.noise++;
+  #endif
+  if(status & USART_STATR_IDLE) {
+    #if UART_RX_STATS == 1
+    UART_RX_watermark();
+    #endif
+    #if UART_RX_FRAMES == 1
+    UART_RX_event(UART_EVT_IDLE);
+    #endif
+  }
+  PROF_END(PROF_UART_IRQ);
+}
+
+// DMA RX interrupt service routine: half-transfer or transfer complete
+void DMA1_Channel5_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel5_IRQHandler(void) {
+  uint32_t flags = DMA1->INTFR;
+  DMA1->INTFCR = DMA_CGIF5;                   // clear interrupt flags
+  #if UART_RX_STATS == 1
+  if(flags & DMA_TCIF5) UART_RX_laps++;       // count DMA laps
+  UART_RX_watermark();
+  #endif
+  #if UART_RX_FRAMES == 1
+  UART_RX_event((flags & DMA_TCIF5) ? UART_EVT_FULL : UART_EVT_HALF);
+  #endif
+}
+#endif  // UART_RX_IRQ
+
+#if UART_TX_DMA == 1
+// Start DMA transfer of the next contiguous chunk in TX queue (DMA must be idle)
+void UART_TX_start(void) {
+  uint16_t len = SPSC_readLen(UART_TX);
+  UART_TX_len = len;
+  if(!len) return;
+  DMA1_Channel4->CFGR &= ~DMA_CFGR1_EN;
+  DMA1_Channel4->MADDR = (uint32_t)SPSC_readPtr(UART_TX);
+  DMA1_Channel4->CNTR  = len;
+  USART1->STATR = ~USART_STATR_TC;            // clear TC, so flush waits for this chunk
+  DMA1_Channel4->CFGR |= DMA_CFGR1_EN;
+}
+
+// DMA transfer complete interrupt service routine: release chunk and start next one
+void DMA1_Channel4_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel4_IRQHandler(void) {
+  PROF_BEGIN(PROF_UART_TX_IRQ);
+  SPSC_consume(UART_TX, UART_TX_len);         // release sent chunk
+  DMA1->INTFCR = DMA_CGIF4;                   // clear interrupt flags
+  UART_TX_start();                            // chain next chunk (if any)
+  PROF_END(PROF_UART_TX_IRQ);
+}
+
+// Get number of free bytes in TX queue
+uint16_t UART_txFree(void) {
+  return SPSC_free(UART_TX);
+}
+
+// Send byte via UART (wait only if TX buffer is full)
+void UART_write(const char c) {
+  while(SPSC_full(UART_TX));                  // wait if TX queue is full
+  SPSC_put(UART_TX, c);
+  if(!UART_TX_len) UART_TX_start();           // start DMA if idle
+}
+
+// Send buffer via UART (wait only if TX buffer is full)
+void UART_writeBuffer(const char* buf, uint16_t len) {
+  PROF_BEGIN(PROF_UART_WRITE);
+  while(len) {
+    uint16_t cnt = SPSC_writeLen(UART_TX);
+    uint16_t i;
+    char* dst;
+    if(!cnt) continue;                        // TX queue is full, wait for DMA
+    if(cnt > len) cnt = len;                  // copy contiguous part only
+    len -= cnt;
+    dst  = SPSC_writePtr(UART_TX);
+    for(i = cnt; i; i--) *dst++ = *buf++;
+    SPSC_commit(UART_TX, cnt);
+    if(!UART_TX_len) UART_TX_start();         // start DMA if idle
+  }
+  PROF_END(PROF_UART_WRITE);
+}
+
+// Wait until all bytes in TX buffer are transmitted
+void UART_flush(void) {
+  while(UART_TX_len);                         // wait for DMA to finish
+  while(!UART_completed());                   // wait for last byte to leave
+}
+
+#else  // UART_TX_DMA == 0
+// Get number of free bytes in TX data register
+uint16_t UART_txFree(void) {
+  return((USART1->STATR & USART_STATR_TXE) ? 1 : 0);
+}
+
+// Send byte via UART (wait until TX data register is empty)
+void UART_write(const char c) {
+  while(!(USART1->STATR & USART_STATR_TXE));  // wait for previous byte
+  USART1->DATAR = c;                          // send byte (clears TC)
+}
+
+// Send buffer via UART
+void UART_writeBuffer(const char* buf, uint16_t len) {
+  while(len--) UART_write(*buf++);
+}
+
+// Wait until last byte has left the shift register
+void UART_flush(void) {
+  while(!UART_completed());
+}
+#endif  // UART_TX_DMA
@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+# ===================================================================================
+# Project:   iapupload - Upload Tool for the CH32V003 UART IAP Bootloader
+# Version:   v1.0
+# Year:      2023
+# Author:    Stefan Wagner
+# Github:    https://github.com/wagiminator
+# License:   MIT License
+# ===================================================================================
+#
+# Description:
+# ------------
+# Simple Python tool for uploading firmware to a CH32V003 running the UART IAP
+# bootloader (uart_iap.c) via USB-to-serial converter. The firmware is streamed in
+# pages of 64 bytes with a CRC32 each. Up to 'window' pages (reported by the
+# bootloader) are sent ahead without waiting for their acknowledge, so the line
+# stays busy while the MCU programs the flash. Pages containing only 0xFF are
+# skipped, since the application area is erased before. Finally, the CRC32 of the
+# whole image is verified by the bootloader before it accepts the image.
+#
+# Dependencies:
+# -------------
+# - pyserial
+#
+# Operating Instructions:
+# -----------------------
+# You need to install PySerial to use iapupload.
+# Install it via "python3 -m pip install pyserial".
+# You may need to install a driver for your USB-to-serial converter.
+#
+# Connect your USB-to-serial converter to your MCU:
+# USB2SERIAL      CH32V003
+#        RXD <--- PD5
+#        TXD ---> PD6
+#        GND ---> GND
+#
+# The firmware must be linked with linker/ch32v003_app.ld (start address 0x0800).
+# Run "python3 iapupload.py -f firmware.bin", then reset the MCU within 10 seconds.
+# Run "python3 iapupload.py -h" for all options.
+
+# If the PID/VID of the USB-to-Serial converter is known, it can be defined here,
+# which can make the auto-detection a lot faster. If not, comment out or delete.
+IAP_VID  = '1A86'
+IAP_PID  = '7523'
+
+# Define BAUD rate here, must match UART_BAUD of the bootloader (default: 460800)
+IAP_BAUD = 460800
+
+# Libraries
+import sys
+import time
+import zlib
+import argparse
+from serial import Serial
+from serial.tools.list_ports import comports
+
+# ===================================================================================
+# Main Function
+# ===================================================================================
+
+def _main():
+    # Parse command line arguments
+    parser = argparse.ArgumentParser(description='Upload tool for the CH32V003 UART IAP bootloader')
+    parser.add_argument('-p', '--port',     help='serial port (default: auto-detect)')
+    parser.add_argument('-b', '--baud',     type=int, default=IAP_BAUD, help='BAUD rate (default: %d)' % IAP_BAUD)
+    parser.add_argument('-t', '--timeout',  type=float, default=10, help='seconds to wait for bootloader (default: 10)')
+    parser.add_argument('-n', '--norun',    action='store_true', help='do not start application after upload')
+    parser.add_argument('-f', '--flash',    help='write BIN file to flash and verify')
+    args = parser.parse_args(sys.argv[1:])
+
+    # Check arguments
+    if args.flash is None:
+        print('No arguments - no action!')
+        sys.exit(0)
+
+    # Establish connection to bootloader
+    try:
+        print('Waiting for bootloader (reset MCU now) ...')
+        isp = Programmer(args.port, args.baud, args.timeout)
+        print('SUCCESS: Found bootloader v%x.%x on %s (%d bytes, window %d pages).' % \
+              (isp.version >> 4, isp.version & 0x0f, isp.port, isp.pages * IAP_PAGE_SIZE, isp.window))
+    except Exception as ex:
+        sys.stderr.write('ERROR: ' + str(ex) + '!\n')
+        sys.exit(1)
+
+    # Performing actions
+    try:
+        with open(args.flash, 'rb') as f: data = f.read()
+        print('Erasing application area ...')
+        isp.erase(len(data))
+        print('Flashing', args.flash, 'to MCU ...')
+        start = time.time()
+        isp.writeflash(data)
+        duration = time.time() - start
+        print('Verifying ...')
+        isp.verify(data)
+        print('SUCCESS: %d bytes written and verified in %.2fs (%d bytes/s, %d resends).' % \
+              (len(data), duration, len(data) / duration, isp.resends))
+        if not args.norun:
+            print('Starting application ...')
+            isp.run()
+        isp.close()
+
+    except Exception as ex:
+        sys.stderr.write('ERROR: ' + str(ex) + '!\n')
+        isp.close()
+        sys.exit(1)
+
+    print('DONE.')
+    sys.exit(0)
+
+# ===================================================================================
+# Programmer Class
+# ===================================================================================
+
+class Programmer(Serial):
+    def __init__(self, port, baud, timeout):
+        super().__init__(baudrate = baud, timeout = 1)
+        self.resends = 0
+        if port is not None:
+            self.port = port
+        else:
+            self.port = self.findport()
+        self.open()
+        self.sync(timeout)
+
+    # Find port of USB-to-serial converter
+    def findport(self):
+        for p in comports():
+            if (('IAP_VID' not in globals()) or (IAP_VID in p.hwid)) and (('IAP_PID' not in globals()) or (IAP_PID in p.hwid)):
+                return p.device
+        raise Exception('No USB-to-serial converter found')
+
+    # Send SYNC until bootloader answers with its info
+    def sync(self, timeout):
+        end = time.time() + timeout
+        self.timeout = IAP_SYNC_INTERVAL
+        while time.time() < end:
+            self.reset_input_buffer()
+            self.write([IAP_CMD_SYNC])
+            reply = self.read(64)
+            pos   = reply.find(IAP_SYNC_REPLY)
+            if pos >= 0 and len(reply) >= pos + len(IAP_SYNC_REPLY) + 4:
+                info = reply[pos + len(IAP_SYNC_REPLY):]
+                self.version, self.firstpage, self.pages, self.window = info[:4]
+                self.timeout = 1
+                return
+        raise Exception('No bootloader found')
+
+    # Wait for reply (ACK/NAK and one data byte), return data byte or None on NAK
+    def getreply(self):
+        reply = self.read(2)
+        if len(reply) == 2 and reply[0] == IAP_REPLY_ACK:
+            return reply[1]
+        return None
+
+    # Erase application area needed for data
+    def erase(self, size):
+        count = (size + IAP_PAGE_SIZE - 1) // IAP_PAGE_SIZE
+        if count > self.pages:
+            raise Exception('Firmware is too big (max %d bytes)' % (self.pages * IAP_PAGE_SIZE))
+        self.timeout = 1 + count * IAP_ERASE_TIME
+        self.write([IAP_CMD_ERASE, count, count ^ 0xff])
+        reply = self.getreply()
+        self.timeout = 1
+        if reply != count:
+            raise Exception('Failed to erase application area')
+
+    # Write data to application area using a sliding window of pages
+    def writeflash(self, data):
+        data  = data + b'\xff' * (-len(data) % IAP_PAGE_SIZE)
+        pages = [i for i in range(len(data) // IAP_PAGE_SIZE)
+                   if data[i * IAP_PAGE_SIZE:(i + 1) * IAP_PAGE_SIZE] != b'\xff' * IAP_PAGE_SIZE]
+        acked = 0                                       # pages acknowledged
+        sent  = 0                                       # pages sent
+        while acked < len(pages):
+            while sent < len(pages) and sent - acked < self.window:
+                index = pages[sent]
+                frame = bytes([index]) + data[index * IAP_PAGE_SIZE:(index + 1) * IAP_PAGE_SIZE]
+                self.write(bytes([IAP_CMD_WRITE]) + frame + zlib.crc32(frame).to_bytes(4, byteorder='little'))
+                sent += 1
+            if self.getreply() == (pages[acked] & 0xff):
+                acked += 1
+                continue
+            self.resends += sent - acked                # NAK or timeout: resync and
+            if self.resends > IAP_MAX_RESENDS:          # resend unacknowledged pages
+                raise Exception('Too many transmission errors')
+            self.write([IAP_CMD_SYNC] * IAP_FRAME_SIZE) # complete a truncated frame
+            time.sleep(IAP_SYNC_INTERVAL)
+            self.sync(1)
+            sent = acked
+
+    # Verify CRC32 of whole image and let bootloader write image info
+    def verify(self, data):
+        self.timeout = 1
+        self.write(bytes([IAP_CMD_DONE]) + len(data).to_bytes(4, byteorder='little') \
+                 + zlib.crc32(data).to_bytes(4, byteorder='little'))
+        if self.getreply() is None:
+            raise Exception('Image verification failed')
+
+    # Start application
+    def run(self):
+        self.write([IAP_CMD_GO])
+        if self.getreply() is None:
+            raise Exception('Bootloader refused to start application')
+
+# ===================================================================================
+# Bootloader Constants
+# ===================================================================================
+
+IAP_PAGE_SIZE     = 64
+IAP_FRAME_SIZE    = IAP_PAGE_SIZE + 6
+IAP_ERASE_TIME    = 0.01
+IAP_SYNC_INTERVAL = 0.02
+IAP_MAX_RESENDS   = 1000
+
+IAP_REPLY_ACK     = 0x79
+IAP_REPLY_NAK     = 0x1f
+IAP_SYNC_REPLY    = b'\x79IAP'
+
+IAP_CMD_SYNC      = 0x7f
+IAP_CMD_ERASE     = 0x45
+IAP_CMD_WRITE     = 0x57
+IAP_CMD_DONE      = 0x44
+IAP_CMD_GO        = 0x47
+
+# ===================================================================================
+
+if __name__ == "__main__":
+    _main()
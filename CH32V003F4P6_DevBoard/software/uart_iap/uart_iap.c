@@ -0,0 +1,321 @@
+// ===================================================================================
+// Project:   UART In-Application Programming (IAP) Bootloader for CH32V003
+// Version:   v1.1
+// Year:      2023
+// Author:    Stefan Wagner
+// Github:    https://github.com/wagiminator
+// EasyEDA:   https://easyeda.com/wagiminator
+// License:   http://creativecommons.org/licenses/by-sa/3.0/
+// ===================================================================================
+//
+// Description:
+// ------------
+// Resident bootloader which updates the firmware via UART (PD5: TX, PD6: RX, 460800
+// BAUD, 8N1), so that no WCH-LinkE is needed in the field. The bootloader occupies
+// the first 2KB of the code flash, the application starts at 0x0800 and must be
+// linked with linker/ch32v003_app.ld. The last page (0x3FC0) holds the image info
+// (magic, size, CRC32), which is written only after the whole image was verified.
+//
+// After reset, the bootloader waits IAP_WAIT_MS for a sync byte from the host. If
+// none arrives and the image info is present and the CRC32 over the application
+// matches, the application is started. Otherwise the bootloader stays active.
+//
+// The firmware is streamed in pages of 64 bytes, each protected by a CRC32. The
+// received bytes are written by DMA into the circular RX buffer of uart_dma.c, so
+// the next pages keep streaming in while the CPU is stalled by fast page
+// programming of the current one. The host may send as many pages ahead as fit into
+// the RX buffer and waits for the acknowledge of the oldest page before sending the
+// next one (sliding window), so the line is never idle and the buffer never
+// overflows. The application pages are erased with one command before streaming.
+// The short replies are sent polled (UART_TX_DMA = 0), so the bootloader uses no
+// interrupts at all and needs no vector table.
+//
+// Protocol (host -> bootloader, all values little-endian):
+// - SYNC:  0x7F                         -> ACK 'I' 'A' 'P' version page pages window
+// - ERASE: 'E' n ~n                     -> ACK/NAK (erase info page and n app pages)
+// - WRITE: 'W' i data[64] crc32         -> ACK/NAK i (write app page i)
+// - DONE:  'D' size[4] crc32[4]         -> ACK/NAK (verify image, write image info)
+// - GO:    'G'                          -> ACK and start app / NAK if image is invalid
+// The CRC32 of WRITE covers the page index and data. After a CRC error, the
+// bootloader discards everything until the line is idle and then sends NAK, the
+// host resynchronizes and resends all pages from the first unacknowledged one.
+//
+// Use tools/iapupload.py to upload the application via a USB-to-serial converter:
+// python3 tools/iapupload.py -f firmware.bin
+//
+// References:
+// -----------
+// - CNLohr ch32v003fun: https://github.com/cnlohr/ch32v003fun
+// - WCH Nanjing Qinheng Microelectronics: http://wch.cn
+//
+// Compilation Instructions:
+// -------------------------
+// - Make sure GCC toolchain (gcc-riscv64-unknown-elf, newlib) and Python3 with PyUSB
+//   is installed. In addition, Linux requires access rights to WCH-LinkE programmer.
+// - Connect the WCH-LinkE programmer to the MCU board.
+// - Run 'make flash' to upload the bootloader once.
+// - Copy linker/ch32v003_app.ld into the application project and set LDSCRIPT in
+//   its makefile accordingly. The application must not use the last flash page.
+
+
+// ===================================================================================
+// Libraries, Definitions and Macros
+// ===================================================================================
+#include <system.h>                           // system functions
+#include <flash.h>                            // FLASH functions
+#include <uart_dma.h>                         // UART with DMA RX ring buffer
+
+// Bootloader parameters
+#define IAP_VERSION     0x10                  // protocol version
+#define IAP_WAIT_MS     100                   // time to wait for host after reset
+#define IAP_IDLE_US     1000                  // idle time to end discarding input
+#define IAP_APP_PAGE    32                    // first page of application (0x0800)
+#define IAP_INFO_PAGE   255                   // page with image info (last page)
+#define IAP_APP_PAGES   (IAP_INFO_PAGE - IAP_APP_PAGE)
+#define IAP_APP_ADDR    FLASH_PAGE_BASE(IAP_APP_PAGE)
+#define IAP_APP_ENTRY   ((uint32_t)IAP_APP_PAGE * FLASH_PAGE_SIZE)  // linked address
+#define IAP_MAGIC       0x31504149            // "IAP1"
+
+// Protocol
+#define IAP_ACK         0x79                  // acknowledge
+#define IAP_NAK         0x1F                  // not acknowledge
+#define IAP_CMD_SYNC    0x7F                  // synchronize, get bootloader info
+#define IAP_CMD_ERASE   'E'                   // erase application area
+#define IAP_CMD_WRITE   'W'                   // write page
+#define IAP_CMD_DONE    'D'                   // verify image and write image info
+#define IAP_CMD_GO      'G'                   // start application
+#define IAP_FRAME       (1 + 1 + FLASH_PAGE_SIZE + 4)       // size of WRITE command
+#define IAP_WINDOW      (UART_RX_BUF_SIZE / IAP_FRAME)      // pages in flight
+
+// Image info in last page
+typedef struct {
+  uint32_t magic;                             // IAP_MAGIC if image is valid
+  uint32_t size;                              // image size in bytes
+  uint32_t crc;                               // CRC32 of image
+} IAP_INFO_t;
+
+#define IAP_info        ((const IAP_INFO_t*)FLASH_PAGE_BASE(IAP_INFO_PAGE))
+
+// Page buffer (word aligned for fast page programming)
+uint32_t IAP_page[FLASH_PAGE_SIZE / 4];
+
+// ===================================================================================
+// CRC32 Functions (IEEE 802.3, same as zlib.crc32; nibble table)
+// ===================================================================================
+const uint32_t CRC_table[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158,
+  0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4,
+  0xA00AE278, 0xBDBDF21C
+};
+
+// Update CRC32 (start with 0xFFFFFFFF, invert result) with len bytes from buf
+uint32_t CRC_update(uint32_t crc, const uint8_t* buf, uint16_t len) {
+  while(len--) {
+    crc ^= *buf++;
+    crc = (crc >> 4) ^ CRC_table[crc & 0x0F];
+    crc = (crc >> 4) ^ CRC_table[crc & 0x0F];
+  }
+  return crc;
+}
+
+// ===================================================================================
+// Receive Functions
+// ===================================================================================
+
+// Copy len bytes from UART RX ring buffer to buf (waits until received)
+void IAP_receive(uint8_t* buf, uint16_t len) {
+  UART_SPAN_t span;
+  uint16_t cnt, i;
+  while(len) {
+    if(!UART_rxSpans(&span)) continue;        // wait for DMA to deliver
+    cnt = (span.len1 < len) ? span.len1 : len;
+    for(i = cnt; i; i--) *buf++ = *span.data1++;
+    UART_consume(cnt);
+    len -= cnt;
+  }
+}
+
+// Receive 32-bit little-endian value
+uint32_t IAP_receiveWord(void) {
+  uint32_t value;
+  IAP_receive((uint8_t*)&value, 4);
+  return value;
+}
+
+// Discard received bytes until line is idle for IAP_IDLE_US
+void IAP_discard(void) {
+  UART_SPAN_t span;
+  uint32_t start = STK->CNT;
+  while((uint32_t)(STK->CNT - start) < IAP_IDLE_US * DLY_US_TIME) {
+    if(UART_rxSpans(&span)) {
+      UART_consume(span.len1 + span.len2);
+      start = STK->CNT;
+    }
+  }
+}
+
+// Send reply (ACK/NAK) with one data byte
+void IAP_reply(uint8_t result, uint8_t data) {
+  UART_write(result);
+  UART_write(data);
+}
+
+// ===================================================================================
+// Image Functions
+// ===================================================================================
+
+// Check image info and CRC32 over application image
+uint8_t IAP_valid(void) {
+  if(IAP_info->magic != IAP_MAGIC) return 0;
+  if(IAP_info->size > IAP_APP_PAGES * FLASH_PAGE_SIZE) return 0;
+  return(~CRC_update(0xFFFFFFFF, (const uint8_t*)IAP_APP_ADDR, IAP_info->size) == IAP_info->crc);
+}
+
+// Check if page is erased
+uint8_t IAP_blank(uint8_t page) {
+  const uint32_t* ptr = (const uint32_t*)FLASH_PAGE_BASE(page);
+  uint8_t i;
+  for(i = FLASH_PAGE_SIZE / 4; i; i--) if(*ptr++ != 0xFFFFFFFF) return 0;
+  return 1;
+}
+
+// Compare page with page buffer
+uint8_t IAP_verify(uint8_t page) {
+  const uint32_t* ptr = (const uint32_t*)FLASH_PAGE_BASE(page);
+  uint8_t i;
+  for(i = 0; i < FLASH_PAGE_SIZE / 4; i++) if(ptr[i] != IAP_page[i]) return 0;
+  return 1;
+}
+
+// Release peripherals and start application
+void IAP_start(void) {
+  UART_flush();                               // wait until last reply has left (TC)
+  __disable_irq();
+  NVIC_DisableIRQ(USART1_IRQn);               // disable all UART interrupts...
+  NVIC_DisableIRQ(DMA1_Channel4_IRQn);
+  NVIC_DisableIRQ(DMA1_Channel5_IRQn);
+  DMA1_Channel4->CFGR = 0;                    // stop DMA channels
+  DMA1_Channel5->CFGR = 0;
+  DMA1->INTFCR = DMA_CGIF4 | DMA_CGIF5;       // clear DMA interrupt flags
+  RCC->APB2PRSTR = RCC_USART1RST | RCC_IOPDRST | RCC_AFIORST;
+  RCC->APB2PRSTR = 0;                         // reset UART and its pins
+  RCC->AHBPCENR &= ~RCC_DMA1EN;               // disable DMA clock
+  NVIC_ClearPendingIRQ(USART1_IRQn);          // ...and clear their pending bits
+  NVIC_ClearPendingIRQ(DMA1_Channel4_IRQn);
+  NVIC_ClearPendingIRQ(DMA1_Channel5_IRQn);
+  ((void (*)(void))IAP_APP_ENTRY)();          // jump to application reset vector
+}
+
+// ===================================================================================
+// Command Handlers
+// ===================================================================================
+
+// SYNC: send bootloader info
+void IAP_sync(void) {
+  static const char info[] = {IAP_ACK, 'I', 'A', 'P', IAP_VERSION,
+                              IAP_APP_PAGE, IAP_APP_PAGES, IAP_WINDOW};
+  UART_writeBuffer(info, sizeof(info));
+}
+
+// ERASE: erase image info (invalidates image) and application pages
+void IAP_erase(void) {
+  uint8_t cnt[2], i;
+  IAP_receive(cnt, 2);
+  if((cnt[0] != (uint8_t)~cnt[1]) || (cnt[0] > IAP_APP_PAGES)) {
+    IAP_reply(IAP_NAK, 0);
+    return;
+  }
+  FLASH_unlock();
+  FLASH_PAGE_erase(IAP_INFO_PAGE);
+  for(i = 0; i < cnt[0]; i++) {
+    if(!IAP_blank(IAP_APP_PAGE + i)) FLASH_PAGE_erase(IAP_APP_PAGE + i);
+  }
+  FLASH_lock();
+  IAP_reply(IAP_ACK, cnt[0]);
+}
+
+// WRITE: receive page, check CRC, program page while next page streams in
+void IAP_write(void) {
+  uint8_t  index;
+  uint8_t  page;
+  uint32_t crc;
+  IAP_receive(&index, 1);
+  IAP_receive((uint8_t*)IAP_page, FLASH_PAGE_SIZE);
+  crc = IAP_receiveWord();
+  crc = ~crc ^ CRC_update(CRC_update(0xFFFFFFFF, &index, 1), (uint8_t*)IAP_page, FLASH_PAGE_SIZE);
+  if(crc || (index >= IAP_APP_PAGES)) {       // corrupted or lost bytes:
+    IAP_discard();                            // drop the rest of the window
+    IAP_reply(IAP_NAK, index);
+    return;
+  }
+  page = IAP_APP_PAGE + index;
+  FLASH_unlock();
+  if(!IAP_blank(page)) FLASH_PAGE_erase(page);  // page was not erased or is resent
+  FLASH_PAGE_write(page, IAP_page);
+  FLASH_lock();
+  IAP_reply(IAP_verify(page) ? IAP_ACK : IAP_NAK, index);
+}
+
+// DONE: verify whole image, write image info if CRC32 matches
+void IAP_done(void) {
+  uint8_t i;
+  uint32_t size = IAP_receiveWord();
+  uint32_t crc  = IAP_receiveWord();
+  if((size > IAP_APP_PAGES * FLASH_PAGE_SIZE)
+  || (~CRC_update(0xFFFFFFFF, (const uint8_t*)IAP_APP_ADDR, size) != crc)) {
+    IAP_reply(IAP_NAK, 0);
+    return;
+  }
+  for(i = 3; i < FLASH_PAGE_SIZE / 4; i++) IAP_page[i] = 0xFFFFFFFF;
+  IAP_page[0] = IAP_MAGIC;
+  IAP_page[1] = size;
+  IAP_page[2] = crc;
+  FLASH_unlock();
+  FLASH_PAGE_erase(IAP_INFO_PAGE);
+  FLASH_PAGE_write(IAP_INFO_PAGE, IAP_page);
+  FLASH_lock();
+  IAP_reply(IAP_verify(IAP_INFO_PAGE) ? IAP_ACK : IAP_NAK, 0);
+}
+
+// GO: start application if image is valid
+void IAP_go(void) {
+  if(!IAP_valid()) {
+    IAP_reply(IAP_NAK, 0);
+    return;
+  }
+  IAP_reply(IAP_ACK, 0);
+  IAP_start();
+}
+
+// ===================================================================================
+// Main Function
+// ===================================================================================
+int main(void) {
+  uint32_t start;
+  uint8_t  cmd;
+
+  // Setup
+  UART_init();                                // init UART with DMA RX ring
+
+  // Wait for host, start application if there is none and the image is valid
+  start = STK->CNT;
+  while(!UART_available()) {
+    if((uint32_t)(STK->CNT - start) >= IAP_WAIT_MS * DLY_MS_TIME) {
+      if(IAP_valid()) IAP_start();
+      break;
+    }
+  }
+
+  // Loop
+  while(1) {
+    IAP_receive(&cmd, 1);                     // wait for command
+    switch(cmd) {
+      case IAP_CMD_SYNC:  IAP_sync();  break;
+      case IAP_CMD_ERASE: IAP_erase(); break;
+      case IAP_CMD_WRITE: IAP_write(); break;
+      case IAP_CMD_DONE:  IAP_done();  break;
+      case IAP_CMD_GO:    IAP_go();    break;
+      default:            break;      // ignore everything else
+    }
+  }
+}
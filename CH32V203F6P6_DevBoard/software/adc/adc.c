@@ -11,6 +11,8 @@
 // Description:
 // ------------
 // Sends ADC value of PA0, Vdd and chip temperature via UART (TX pin is PA2).
+// Set DEBUG_TRACE in include/debug_serial.h to 1 to send compact binary trace records
+// instead of text and decode them on the PC with 'make trace'.
 //
 // References:
 // -----------
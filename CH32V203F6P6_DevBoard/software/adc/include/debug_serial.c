@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for CH32V203                                  * v1.0 *
+// Basic Serial Debug Functions for CH32V203                                  * v1.4 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -7,6 +7,18 @@
 
 #if DEBUG_ENABLE > 0
 
+#if DEBUG_BUFFERED > 0
+#define DEBUG_MSTATUS_MIE 0x08                    // mstatus: machine interrupt enable
+#define DEBUG_IRQ_enabled() (__get_MSTATUS() & DEBUG_MSTATUS_MIE)
+
+// Circular TX buffer, drained by DMA channel 7 in the background
+char DEBUG_TX_buffer[DEBUG_BUF_SIZE];
+volatile uint16_t DEBUG_TX_hptr;                  // head pointer, written by DEBUG_write
+volatile uint16_t DEBUG_TX_tptr;                  // tail pointer, advanced by DMA interrupt
+volatile uint16_t DEBUG_TX_len;                   // length of running DMA transfer (0: idle)
+volatile uint32_t DEBUG_dropped;                  // number of dropped bytes
+#endif
+
 // Init debug interface (UART TX)
 void DEBUG_init(void) {
   // Set pin PA2 to output, push-pull, 10MHz, auxiliary
@@ -18,22 +30,130 @@ void DEBUG_init(void) {
   RCC->APB1PCENR |= RCC_USART2EN;
   USART2->BRR     = ((2 * F_CPU / DEBUG_BAUD) + 1) / 2;
   USART2->CTLR1   = USART_CTLR1_TE | USART_CTLR1_UE;
+
+  #if DEBUG_BUFFERED > 0
+  // Setup DMA channel 7 for USART2 TX
+  DEBUG_TX_hptr = 0;
+  DEBUG_TX_tptr = 0;
+  DEBUG_TX_len  = 0;
+  DEBUG_dropped = 0;
+  RCC->AHBPCENR |= RCC_DMA1EN;
+  USART2->CTLR3 |= USART_CTLR3_DMAT;
+  DMA1_Channel7->PADDR = (uint32_t)&USART2->DATAR;
+  DMA1_Channel7->CFGR  = DMA_CFGR1_MINC           // increment memory address
+                       | DMA_CFGR1_DIR            // memory to peripheral
+                       | DMA_CFGR1_TCIE;          // transfer complete interrupt enable
+  NVIC_EnableIRQ(DMA1_Channel7_IRQn);             // enable DMA channel 7 interrupt
+  #endif
+}
+
+#if DEBUG_BUFFERED > 0
+// Start DMA transfer of the next contiguous chunk in TX buffer (DMA must be idle)
+static void DEBUG_TX_start(void) {
+  uint16_t head = DEBUG_TX_hptr;
+  uint16_t tail = DEBUG_TX_tptr;
+  uint16_t len  = (head >= tail) ? (head - tail) : (DEBUG_BUF_SIZE - tail);
+  DEBUG_TX_len = len;
+  if(!len) return;
+  DMA1_Channel7->CFGR &= ~DMA_CFGR1_EN;
+  DMA1_Channel7->MADDR = (uint32_t)&DEBUG_TX_buffer[tail];
+  DMA1_Channel7->CNTR  = len;
+  DMA1_Channel7->CFGR |= DMA_CFGR1_EN;
+}
+
+// Release transmitted chunk and start next one
+static void DEBUG_TX_next(void) {
+  uint16_t tail = DEBUG_TX_tptr + DEBUG_TX_len;
+  if(tail >= DEBUG_BUF_SIZE) tail = 0;
+  DEBUG_TX_tptr = tail;
+  DMA1->INTFCR = DMA_CGIF7;                       // clear interrupt flags
+  DEBUG_TX_start();                               // chain next chunk (if any)
 }
 
+// DMA transfer complete interrupt service routine
+void DMA1_Channel7_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel7_IRQHandler(void) {
+  DEBUG_TX_next();
+}
+
+// Service DMA by polling if interrupts are disabled (e.g. in fault handler or ISR)
+static void DEBUG_TX_poll(void) {
+  if(!DEBUG_IRQ_enabled() && (DMA1->INTFR & DMA_TCIF7)) DEBUG_TX_next();
+}
+
+// Get number of free bytes in TX buffer
+uint16_t DEBUG_txFree(void) {
+  uint16_t head = DEBUG_TX_hptr;
+  uint16_t tail = DEBUG_TX_tptr;
+  return((tail > head) ? (tail - head - 1) : (DEBUG_BUF_SIZE - 1 - head + tail));
+}
+
+// Send buffer via UART (copy into TX buffer, drop or wait if TX buffer is full)
+void DEBUG_writeBuffer(const char* buf, uint16_t len) {
+  #if DEBUG_DROP > 0
+  if((DEBUG_txFree() < len) && DEBUG_IRQ_enabled()) {   // no space, IRQs enabled?
+    DEBUG_dropped += len;                         // drop whole message
+    return;
+  }
+  #endif
+  while(len) {
+    uint16_t head = DEBUG_TX_hptr;
+    uint16_t tail = DEBUG_TX_tptr;
+    uint16_t cnt  = (tail > head) ? (tail - head - 1)
+                                  : (DEBUG_BUF_SIZE - head - (tail == 0));
+    if(!cnt) {                                    // TX buffer is full:
+      DEBUG_TX_poll();                            // wait for DMA
+      continue;
+    }
+    if(cnt > len) cnt = len;                      // copy contiguous part only
+    len -= cnt;
+    while(cnt--) DEBUG_TX_buffer[head++] = *buf++;
+    if(head >= DEBUG_BUF_SIZE) head = 0;
+    DEBUG_TX_hptr = head;
+    if(!DEBUG_TX_len) DEBUG_TX_start();           // start DMA if idle
+  }
+}
+
+// Send byte via UART
+void DEBUG_write(const char c) {
+  DEBUG_writeBuffer(&c, 1);
+}
+
+// Wait until all bytes in TX buffer are transmitted
+void DEBUG_flush(void) {
+  while(DEBUG_TX_len) DEBUG_TX_poll();            // wait for DMA to finish
+  while(!(USART2->STATR & USART_STATR_TC));       // wait for last byte to leave
+}
+
+#else
 // Send byte via UART
 void DEBUG_write(const char c) {
   while(!(USART2->STATR & USART_STATR_TXE));
   USART2->DATAR = c;
 }
 
+// Send buffer via UART
+void DEBUG_writeBuffer(const char* buf, uint16_t len) {
+  while(len--) DEBUG_write(*buf++);
+}
+
+// Wait until last byte is transmitted
+void DEBUG_flush(void) {
+  while(!(USART2->STATR & USART_STATR_TC));
+}
+#endif
+
+#if DEBUG_TRACE == 0
 // Send string via UART
 void DEBUG_print(const char* str) {
-  while(*str) DEBUG_write(*str++);
+  const char* end = str;
+  while(*end) end++;
+  DEBUG_writeBuffer(str, end - str);
 }
 
 // Send string via UART (for printf)
 int puts(const char* str) {
-  while(*str) DEBUG_write(*str++);
+  DEBUG_print(str);
   return 1;
 }
 
@@ -43,19 +163,15 @@ void DEBUG_println(const char* str) {
   DEBUG_write('\n');
 }
 
-// Print decimal value
+// Print decimal value (division by constant 10 compiles to multiplication)
 void DEBUG_printD(uint32_t value) {
-  uint8_t digitval;                               // current digit value
-  uint8_t leadflag = 0;                           // flag for leading spaces
-  uint32_t divider = 1000000000;                  // current divider
-  while(divider) {                                // for all digits
-    digitval = value / divider;                   // calculate digit value
-    value    = value % divider;                   // set value to division remainder
-    divider /= 10;                                // calculate next divider
-    if(digitval) leadflag++;                      // end of leading spaces
-    if(!divider) leadflag++;                      // least digit has to be printed
-    if(leadflag) DEBUG_write(digitval + '0');     // print the digit
-  }
+  char buf[10];                                   // max 10 digits
+  char* ptr = buf + sizeof(buf);                  // fill buffer from the end
+  do {                                            // for all digits
+    *--ptr = value % 10 + '0';                    // remainder is digit value
+    value /= 10;                                  // continue with quotient
+  } while(value);                                 // until no digits left
+  DEBUG_writeBuffer(ptr, buf + sizeof(buf) - ptr); // send all digits at once
 }
 
 // Convert byte nibble into hex character and print it via UART
@@ -80,5 +196,6 @@ void DEBUG_printL(uint32_t value) {
   DEBUG_printW(value >> 16);
   DEBUG_printW(value);
 }
+#endif  // DEBUG_TRACE == 0
 
 #endif
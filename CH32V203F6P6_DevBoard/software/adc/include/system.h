@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic System Functions for CH32V203                                        * v1.0 *
+// Basic System Functions for CH32V203                                        * v1.1 *
 // ===================================================================================
 //
 // This file must be included!!! The system configuration and the system clock are 
@@ -49,6 +49,9 @@
 // DLY_us(n)              // delay n microseconds
 // DLY_ms(n)              // delay n milliseconds
 //
+// TIME_cycles()          // get 64-bit number of system ticks since start
+// TIME_micros64()        // get 64-bit number of microseconds since start
+//
 // RST_now()              // conduct software reset
 // RST_clearFlags()       // clear all reset flags
 // RST_wasLowPower()      // check if last reset was caused by low power
@@ -223,6 +226,15 @@ void RTC_ALARM_set(uint32_t n);   // set RTC ALARM
 #define DLY_cycles        DLY_ticks                     // alias
 void DLY_ticks(uint32_t n);                             // delay n system ticks
 
+// ===================================================================================
+// Timestamp Functions
+// ===================================================================================
+// SYSTICK is a 64-bit counter, it is read consistently without disabling interrupts,
+// so the functions can be called from any context. F_CPU must be a multiple of 1MHz
+// for micros.
+uint64_t TIME_cycles(void);                             // 64-bit system ticks
+uint64_t TIME_micros64(void);                           // 64-bit microseconds
+
 // ===================================================================================
 // Reset Functions
 // ===================================================================================
@@ -0,0 +1,30 @@
+// ===================================================================================
+// Binary Trace Log with Deferred Formatting for CH32V203                     * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "trace.h"
+#include "debug_serial.h"
+
+#if DEBUG_ENABLE > 0
+
+// Send trace record (header, timestamp and arguments) in one go
+void TRACE_emit(uint16_t id, uint8_t argc, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3) {
+  uint8_t  buf[7 + 4 * 4];                        // max record length
+  uint8_t* ptr = buf;
+  uint32_t val[5];
+  uint8_t  i;
+  val[0] = TRACE_TIME(); val[1] = a0; val[2] = a1; val[3] = a2; val[4] = a3;
+  *ptr++ = TRACE_SYNC + argc;                     // sync byte with number of arguments
+  *ptr++ = id;                                    // format ID
+  *ptr++ = id >> 8;
+  for(i = 0; i <= argc; i++) {                    // timestamp and arguments
+    *ptr++ = val[i];
+    *ptr++ = val[i] >> 8;
+    *ptr++ = val[i] >> 16;
+    *ptr++ = val[i] >> 24;
+  }
+  DEBUG_writeBuffer((const char*)buf, ptr - buf);
+}
+
+#endif
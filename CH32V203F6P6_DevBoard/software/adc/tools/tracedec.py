@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+# ===================================================================================
+# Project:   tracedec - Decoder for Binary Trace Logs of CH32Vxxx
+# Version:   v1.1
+# Year:      2023
+# Author:    Stefan Wagner
+# Github:    https://github.com/wagiminator
+# License:   MIT License
+# ===================================================================================
+#
+# Description:
+# ------------
+# Decodes the binary trace records sent by TRACE() (see include/trace.h) back into
+# text. The format strings are read from the ".trace" section of the firmware's ELF
+# file, which is not loaded into the microcontroller's flash. Bytes that do not
+# belong to a valid record are passed through as text. Records without arguments
+# (e.g. from DEBUG_print) are printed verbatim, so a '%' in them needs no escaping.
+#
+# Record format (little-endian):
+#   byte  0      0xA0 + number of arguments (0..4)
+#   bytes 1..2   format ID (offset of format string in .trace section)
+#   bytes 3..6   SysTick timestamp in F_CPU ticks
+#   bytes 7..    arguments, 32 bits each
+#
+# Dependencies:
+# -------------
+# - PySerial (only for reading from a serial port)
+#
+# Operating Instructions:
+# -----------------------
+# Build the firmware with DEBUG_TRACE set to 1 in debug_serial.h and keep the ELF
+# file (e.g. 'make elf'). Connect the board's debug UART to your PC.
+# Run:
+# - python3 tracedec.py [-h] -e ELF [-p PORT] [-b BAUD] [-i INPUT] [-f FCPU] [-t]
+#   -h, --help                show help message and exit
+#   -e ELF, --elf ELF         firmware ELF file with .trace section
+#   -p PORT, --port PORT      serial port to read from (e.g. /dev/ttyUSB0)
+#   -b BAUD, --baud BAUD      baud rate of serial port (default: 115200)
+#   -i INPUT, --input INPUT   read from captured binary file instead of serial port
+#   -f FCPU, --fcpu FCPU      SysTick frequency in Hz for timestamps (default: 24000000)
+#   -t, --time                prefix each line with timestamp in seconds
+#
+# - Example:
+#   python3 tracedec.py -e adc.elf -p /dev/ttyUSB0 -f 48000000 -t
+
+
+import sys
+import re
+import struct
+import argparse
+
+# Trace record definitions
+TRACE_SYNC    = 0xA0
+TRACE_MAXARGS = 4
+TRACE_HEADER  = 7
+
+# ===================================================================================
+# Main Function
+# ===================================================================================
+
+def _main():
+    # Parse command line arguments
+    parser = argparse.ArgumentParser(description='Decoder for binary trace logs of CH32Vxxx')
+    parser.add_argument('-e', '--elf',   required=True, help='firmware ELF file with .trace section')
+    parser.add_argument('-p', '--port',  help='serial port to read from (e.g. /dev/ttyUSB0)')
+    parser.add_argument('-b', '--baud',  type=int, default=115200, help='baud rate of serial port')
+    parser.add_argument('-i', '--input', help='read from captured binary file instead of serial port')
+    parser.add_argument('-f', '--fcpu',  type=int, default=24000000, help='SysTick frequency in Hz')
+    parser.add_argument('-t', '--time',  action='store_true', help='prefix each line with timestamp')
+    args = parser.parse_args(sys.argv[1:])
+
+    # Read format strings from ELF file
+    try:
+        formats = read_trace_formats(args.elf)
+    except Exception as ex:
+        sys.stderr.write('ERROR: ' + str(ex) + '!\n')
+        sys.exit(1)
+
+    # Open input stream
+    try:
+        if args.input:
+            stream = open(args.input, 'rb')
+        elif args.port:
+            import serial
+            stream = serial.Serial(args.port, args.baud, timeout=0.1)
+        else:
+            stream = sys.stdin.buffer
+    except Exception as ex:
+        sys.stderr.write('ERROR: ' + str(ex) + '!\n')
+        sys.exit(1)
+
+    # Decode stream
+    decoder = TraceDecoder(formats, args.fcpu, args.time)
+    try:
+        while True:
+            data = stream.read(256)
+            if not data:
+                if args.port:
+                    continue
+                break
+            sys.stdout.write(decoder.feed(data))
+            sys.stdout.flush()
+        sys.stdout.write(decoder.feed(b'', final=True))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stream.close()
+
+# ===================================================================================
+# ELF Reader
+# ===================================================================================
+
+def read_trace_formats(filename):
+    with open(filename, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF':
+        raise Exception('Not an ELF file')
+    is64 = (elf[4] == 2)
+    end  = '<' if elf[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(end + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', elf, 0x3A)
+        fmt = end + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(end + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', elf, 0x2E)
+        fmt = end + 'IIIIIIIIII'
+    sections = [struct.unpack_from(fmt, elf, shoff + i * shentsize) for i in range(shnum)]
+    strtab = sections[shstrndx]
+    for sh in sections:
+        name = elf[strtab[4] + sh[0]:].split(b'\0', 1)[0]
+        if name == b'.trace':
+            addr, offset, size = sh[3], sh[4], sh[5]
+            data = elf[offset:offset + size]
+            formats = {}
+            pos = 0
+            while pos < len(data):
+                if data[pos] == 0:            # skip alignment padding
+                    pos += 1
+                    continue
+                stop = data.index(b'\0', pos)
+                formats[(addr + pos) & 0xFFFF] = data[pos:stop].decode('latin-1')
+                pos = stop + 1
+            return formats
+    raise Exception('No .trace section in ELF file')
+
+# ===================================================================================
+# Trace Decoder
+# ===================================================================================
+
+class TraceDecoder:
+    def __init__(self, formats, fcpu, showtime):
+        self.formats  = formats
+        self.fcpu     = fcpu
+        self.showtime = showtime
+        self.buffer   = b''
+        self.newline  = True
+        self.lasttick = None
+        self.ticks    = 0
+
+    # Decode all complete records and text in buffer, return text
+    def feed(self, data, final=False):
+        self.buffer += data
+        out = []
+        pos = 0
+        buf = self.buffer
+        while pos < len(buf):
+            b = buf[pos]
+            if TRACE_SYNC <= b <= TRACE_SYNC + TRACE_MAXARGS:
+                length = TRACE_HEADER + 4 * (b - TRACE_SYNC)
+                if pos + length > len(buf) and not final:
+                    break                     # wait for rest of record
+                if pos + length <= len(buf):
+                    fid, tick = struct.unpack_from('<HI', buf, pos + 1)
+                    if fid in self.formats:
+                        argv = struct.unpack_from('<' + 'I' * (b - TRACE_SYNC), buf, pos + TRACE_HEADER)
+                        self.timestamp(tick)
+                        out.append(self.text(format_record(self.formats[fid], argv)))
+                        pos += length
+                        continue
+            out.append(self.text(chr(b)))     # not a record: pass through as text
+            pos += 1
+        self.buffer = buf[pos:]
+        return ''.join(out)
+
+    # Extend 32-bit SysTick to total ticks
+    def timestamp(self, tick):
+        if self.lasttick is not None:
+            self.ticks += (tick - self.lasttick) & 0xFFFFFFFF
+        self.lasttick = tick
+
+    # Add timestamp prefix at start of lines
+    def text(self, s):
+        if not self.showtime:
+            return s
+        out = []
+        for c in s:
+            if self.newline:
+                out.append('[%12.6f] ' % (self.ticks / self.fcpu))
+            out.append(c)
+            self.newline = (c == '\n')
+        return ''.join(out)
+
+# Format record with printf-style format string and 32-bit integer arguments
+def format_record(fmt, argv):
+    if not argv:                              # no arguments: plain string literal
+        return fmt
+    args = iter(argv)
+    def conv(m):
+        if m.group(0) == '%%':
+            return '%'
+        val = next(args, 0)
+        if m.group(2) == 'd' and val & 0x80000000:
+            val -= 0x100000000
+        if m.group(2) == 'c':
+            return chr(val & 0xFF)
+        return ('%' + m.group(1) + m.group(2)) % val
+    return re.sub(r'%%|%([-0 ]?\d*)[l]?([udixXc])', conv, fmt)
+
+# ===================================================================================
+
+if __name__ == "__main__":
+    _main()
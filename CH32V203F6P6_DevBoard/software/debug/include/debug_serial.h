@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for CH32V203                                  * v1.0 *
+// Basic Serial Debug Functions for CH32V203                                  * v1.4 *
 // ===================================================================================
 //
 // Functions available:
@@ -8,6 +8,7 @@
 // DEBUG_setBaud(n)         Set BAUD rate
 //
 // DEBUG_write(c)           Send character
+// DEBUG_writeBuffer(p,n)   Send n bytes from buffer p
 // DEBUG_print(s)           Send string
 // DEBUG_println(s)         Send string with newline
 // DEBUG_printS(s)          Send string
@@ -16,6 +17,20 @@
 // DEBUG_printW(n)          Send hex word value as string
 // DEBUG_printB(n)          Send hex byte value as string
 // DEBUG_newline()          Send newline
+// DEBUG_flush()            Wait until all bytes are transmitted (e.g. before reset/sleep)
+//
+// If DEBUG_BUFFERED is set, DEBUG_write() and DEBUG_writeBuffer() only copy the data
+// into a TX ring buffer which is sent in the background by DMA channel 7. When the
+// buffer is full, the data is either dropped (DEBUG_DROP = 1, counted in DEBUG_dropped)
+// or the functions wait for free space (DEBUG_DROP = 0). When interrupts are disabled
+// (e.g. in a fault handler), the DMA is serviced by polling and the functions always
+// wait, so call DEBUG_flush() there before halting or resetting.
+// Do not use the DEBUG functions from both main loop and interrupts at the same time.
+//
+// If DEBUG_TRACE is set, the DEBUG_print functions and DEBUG_printf send binary trace
+// records instead of text, which are decoded on the host (needs trace.h/trace.c, the
+// ".trace" section in the linker script and tools/tracedec.py). Strings and formats
+// must then be string literals, printf arguments integers (max 4).
 //
 // USART2 is used, TX pin is PA2.
 //
@@ -28,11 +43,15 @@ extern "C" {
 #endif
 
 #include <stdio.h>
-#include "ch32v203.h"
+#include "system.h"
 
 // DEBUG parameters
 #define DEBUG_ENABLE      1                 // enable serial DEBUG (0:no, 1:yes)
 #define DEBUG_BAUD        115200            // default UART baud rate
+#define DEBUG_BUFFERED    1                 // 1: send in background via DMA
+#define DEBUG_BUF_SIZE    256               // TX buffer size
+#define DEBUG_DROP        0                 // buffer full: 0: wait, 1: drop message
+#define DEBUG_TRACE       0                 // 1: send binary trace records (trace.h)
 
 // DEBUG macros
 #define DEBUG_setBAUD(n)  USART2->BRR = ((2*F_CPU/(n))+1)/2;  // set BAUD rate
@@ -42,6 +61,19 @@ extern "C" {
 #if DEBUG_ENABLE > 0
   void DEBUG_init(void);                    // init UART with default BAUD rate
   void DEBUG_write(const char c);           // send character via UART
+  void DEBUG_writeBuffer(const char* buf, uint16_t len); // send buffer via UART
+  void DEBUG_flush(void);                   // wait until all bytes are transmitted
+  #if DEBUG_TRACE > 0
+  #include "trace.h"
+  #define DEBUG_print(s)    TRACE(s)         // send string as trace record
+  #define DEBUG_println(s)  TRACE(s "\n")    // send string with newline as trace record
+  #define DEBUG_printD(n)   TRACE("%u", n)   // send decimal value as trace record
+  #define DEBUG_printL(n)   TRACE("%08X", n) // send hex long value as trace record
+  #define DEBUG_printW(n)   TRACE("%04X", n) // send hex word value as trace record
+  #define DEBUG_printB(n)   TRACE("%02X", n) // send hex byte value as trace record
+  #define DEBUG_newline()   TRACE("\n")      // send newline as trace record
+  #define DEBUG_printf(format, ...)         TRACE(format, ##__VA_ARGS__)
+  #else
   void DEBUG_print(const char* str);        // send string via UART
   void DEBUG_println(const char* str);      // send string with newline via UART
   void DEBUG_printD(uint32_t value);        // send decimal value as string
@@ -49,9 +81,16 @@ extern "C" {
   void DEBUG_printW(uint16_t value);        // send hex word value as string
   void DEBUG_printB(uint8_t value);         // send hex byte value as string
   #define DEBUG_printf(format, ...)         printf(format, ##__VA_ARGS__)
+  #endif
+  #if DEBUG_BUFFERED > 0
+  uint16_t DEBUG_txFree(void);              // get number of free bytes in TX buffer
+  extern volatile uint32_t DEBUG_dropped;   // number of dropped bytes
+  #endif
 #else
   #define DEBUG_init()
   #define DEBUG_write(x)
+  #define DEBUG_writeBuffer(x,y)
+  #define DEBUG_flush()
   #define DEBUG_print(x)
   #define DEBUG_println(x)
   #define DEBUG_printD(x)
@@ -61,7 +100,9 @@ extern "C" {
   #define DEBUG_printf(X...)
 #endif
 
+#ifndef DEBUG_newline
 #define DEBUG_newline() DEBUG_write('\n')   // send newline
+#endif
 #define DEBUG_printS    DEBUG_print         // alias for print
 
 #ifdef __cplusplus
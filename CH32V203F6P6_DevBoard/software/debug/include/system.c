@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic System Functions for CH32V203                                        * v1.0 *
+// Basic System Functions for CH32V203                                        * v1.1 *
 // ===================================================================================
 //
 // This file must be included!!!!
@@ -178,6 +178,34 @@ void DLY_ticks(uint32_t n) {
   while(((int32_t)(STK->CNTL - end)) < 0 );
 }
 
+// ===================================================================================
+// Timestamp Functions
+// ===================================================================================
+
+// Get 64-bit number of system ticks since start. The high word is read again to
+// detect a carry from the low word in between.
+uint64_t TIME_cycles(void) {
+  uint32_t hi, lo;
+  do {
+    hi = STK->CNTH;
+    lo = STK->CNTL;
+  } while(hi != STK->CNTH);
+  return ((uint64_t)hi << 32) | lo;
+}
+
+// Get 64-bit number of microseconds since start. Long division in 16-bit steps with
+// 32-bit operations only, so no 64-bit division routine is needed.
+uint64_t TIME_micros64(void) {
+  uint64_t ticks = TIME_cycles();
+  uint32_t hi    = ticks >> 32;
+  uint32_t lo    = ticks;
+  uint32_t qh    = hi / DLY_US_TIME;
+  uint32_t r     = ((hi % DLY_US_TIME) << 16) | (lo >> 16);
+  uint32_t qm    = r / DLY_US_TIME;
+  r = ((r % DLY_US_TIME) << 16) | (lo & 0xFFFF);
+  return ((uint64_t)qh << 32) + ((uint64_t)qm << 16) + (r / DLY_US_TIME);
+}
+
 // ===================================================================================
 // Independent Watchdog Timer (IWDG) Functions
 // ===================================================================================
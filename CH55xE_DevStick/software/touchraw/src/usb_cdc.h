@@ -1,10 +1,19 @@
 // ===================================================================================
-// Basic USB CDC Functions for CH551, CH552 and CH554                         * v1.2 *
+// Basic USB CDC Functions for CH551, CH552 and CH554                         * v1.3 *
 // ===================================================================================
 
 #pragma once
 #include <stdint.h>
 
+// ===================================================================================
+// CDC Parameters
+// ===================================================================================
+// Received and sent data is buffered in lock-free SPSC queues (see spsc.h), so the
+// host can send the next packet while the previous one is still being processed,
+// and CDC_write() only has to wait if the TX queue is full.
+#define CDC_RX_SIZE     128       // RX queue size (power of 2, max 128, min EP2_SIZE)
+#define CDC_TX_SIZE     128       // TX queue size (power of 2, max 128)
+
 // ===================================================================================
 // CDC Functions
 // ===================================================================================
@@ -0,0 +1,97 @@
+// ===================================================================================
+// Lock-Free Single-Producer/Single-Consumer Queue                            * v1.0 *
+// ===================================================================================
+//
+// Macros available:
+// -----------------
+// SPSC_define(q, type, size)   Define queue q with size elements of type (size must be
+//                              a power of 2, max 128 on 8051, max 32768 on RISC-V)
+// SPSC_declare(q, type, size)  Declare queue q defined in another file (extern)
+// SPSC_reset(q)                Empty queue (only if producer and consumer are idle)
+// SPSC_SIZE(q)                 Get capacity of queue (number of elements)
+// SPSC_count(q)                Get number of elements in queue
+// SPSC_free(q)                 Get number of free elements in queue
+// SPSC_empty(q)                Check if queue is empty
+// SPSC_full(q)                 Check if queue is full
+//
+// Producer side:
+// SPSC_put(q, v)               Append element v (queue must not be full)
+// SPSC_writePtr(q)             Get pointer to first free element
+// SPSC_writeLen(q)             Get number of contiguous free elements at SPSC_writePtr
+// SPSC_commit(q, n)            Publish n elements written at SPSC_writePtr
+//
+// Consumer side:
+// SPSC_peek(q)                 Get oldest element (queue must not be empty)
+// SPSC_readPtr(q)              Get pointer to oldest element
+// SPSC_readLen(q)              Get number of contiguous elements at SPSC_readPtr
+// SPSC_consume(q, n)           Remove n oldest elements (after reading them)
+//
+// One side (e.g. an interrupt) only ever writes the head index, the other side (e.g.
+// the main loop) only ever writes the tail index, so no side needs to disable
+// interrupts and every operation completes in a fixed number of steps (wait-free).
+// Both indices run freely and are masked on access, so all elements can be used and
+// the element count is simply head - tail. Indices are as wide as the CPU can store
+// atomically: 8 bits on 8051, 16 bits on RISC-V.
+//
+// Ordering: data is always written (read) before the head (tail) index is published
+// with SPSC_commit (SPSC_consume). On RISC-V a compiler barrier enforces this order,
+// which is sufficient because interrupt and main loop run on the same hart. SDCC does
+// not reorder memory accesses across volatile accesses, so no barrier is needed.
+// Bulk transfers (e.g. DMA or USB packets) work in place: get pointer and contiguous
+// length, copy, then commit/consume. At the wrap-around, repeat once.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#include <stdint.h>
+
+// Platform specifics
+#ifdef __SDCC
+  #define SPSC_INDEX_t      uint8_t                 // 8051: 8-bit stores are atomic
+  #define SPSC_STORAGE      __xdata                 // queue buffer in external RAM
+  #define SPSC_barrier()                            // SDCC keeps order of volatiles
+#else
+  #define SPSC_INDEX_t      uint16_t                // 16-bit stores are atomic
+  #define SPSC_STORAGE
+  #define SPSC_barrier()    __asm volatile("" ::: "memory")
+#endif
+
+// Queue definition
+#define SPSC_define(q, type, size)                                                    \
+  SPSC_STORAGE type q##_buf[size];                                                    \
+  volatile SPSC_INDEX_t q##_head;                                                     \
+  volatile SPSC_INDEX_t q##_tail
+
+#define SPSC_declare(q, type, size)                                                   \
+  extern SPSC_STORAGE type q##_buf[size];                                             \
+  extern volatile SPSC_INDEX_t q##_head;                                              \
+  extern volatile SPSC_INDEX_t q##_tail
+
+// Queue state
+#define SPSC_SIZE(q)        ((SPSC_INDEX_t)(sizeof(q##_buf) / sizeof(q##_buf[0])))
+#define SPSC_MASK(q)        (SPSC_SIZE(q) - 1)
+#define SPSC_reset(q)       do {q##_head = 0; q##_tail = 0;} while(0)
+#define SPSC_count(q)       ((SPSC_INDEX_t)(q##_head - q##_tail))
+#define SPSC_free(q)        ((SPSC_INDEX_t)(SPSC_SIZE(q) - SPSC_count(q)))
+#define SPSC_empty(q)       (q##_head == q##_tail)
+#define SPSC_full(q)        (SPSC_count(q) == SPSC_SIZE(q))
+
+// Producer side
+#define SPSC_put(q, v)      do {q##_buf[q##_head & SPSC_MASK(q)] = (v); SPSC_commit(q, 1);} while(0)
+#define SPSC_writePtr(q)    (&q##_buf[q##_head & SPSC_MASK(q)])
+#define SPSC_writeLen(q)    SPSC_contig(SPSC_free(q), q##_head, SPSC_SIZE(q))
+#define SPSC_commit(q, n)   do {SPSC_barrier(); q##_head += (n);} while(0)
+
+// Consumer side
+#define SPSC_peek(q)        (q##_buf[q##_tail & SPSC_MASK(q)])
+#define SPSC_readPtr(q)     (&q##_buf[q##_tail & SPSC_MASK(q)])
+#define SPSC_readLen(q)     SPSC_contig(SPSC_count(q), q##_tail, SPSC_SIZE(q))
+#define SPSC_consume(q, n)  do {SPSC_barrier(); q##_tail += (n);} while(0)
+
+// Limit number of available elements to the part before the wrap-around (avail is
+// evaluated once, so a concurrent update of the other index cannot break the limit)
+static inline SPSC_INDEX_t SPSC_contig(SPSC_INDEX_t avail, SPSC_INDEX_t index, SPSC_INDEX_t size) {
+  index = size - (index & (size - 1));
+  return (avail < index) ? avail : index;
+}
@@ -1,11 +1,12 @@
 // ===================================================================================
-// Basic USB CDC Functions for CH551, CH552 and CH554                         * v1.2 *
+// Basic USB CDC Functions for CH551, CH552 and CH554                         * v1.3 *
 // ===================================================================================
 
 #include "ch554.h"
 #include "usb_cdc.h"
 #include "usb_descr.h"
 #include "usb_handler.h"
+#include "spsc.h"
 
 // ===================================================================================
 // Variables and Defines
@@ -21,10 +22,14 @@ __xdata CDC_LINE_CODING_TYPE CDC_lineCodingB = {
 
 // Variables
 volatile __xdata uint8_t CDC_controlLineState = 0;  // control line state
-volatile __xdata uint8_t CDC_readByteCount = 0;     // number of data bytes in IN buffer
-volatile __xdata uint8_t CDC_readPointer   = 0;     // data pointer for fetching
-volatile __xdata uint8_t CDC_writePointer  = 0;     // data pointer for writing
 volatile __bit CDC_writeBusyFlag = 0;               // flag of whether upload pointer is busy
+volatile __bit CDC_flushFlag     = 0;               // flag of whether to send partial packet
+volatile __bit CDC_readStallFlag = 0;               // flag of whether host is held off (NAK)
+
+// RX queue (producer: EP2 OUT interrupt, consumer: CDC_read)
+// TX queue (producer: CDC_write, consumer: EP2 IN interrupt or CDC_flush when idle)
+SPSC_define(CDC_RX, uint8_t, CDC_RX_SIZE);
+SPSC_define(CDC_TX, uint8_t, CDC_TX_SIZE);
 
 // CDC class requests
 #define SET_LINE_CODING         0x20  // host configures line coding
@@ -37,6 +42,8 @@ volatile __bit CDC_writeBusyFlag = 0;               // flag of whether upload po
 
 // Setup USB-CDC
 void CDC_init(void) {
+  SPSC_reset(CDC_RX);
+  SPSC_reset(CDC_TX);
   USB_init();
   UEP1_T_LEN  = 0;
   UEP2_T_LEN  = 0;
@@ -44,29 +51,55 @@ void CDC_init(void) {
 
 // Check number of bytes in the IN buffer
 uint8_t CDC_available(void) {
-  return CDC_readByteCount;
+  return SPSC_count(CDC_RX);
 }
 
 // Check if OUT buffer is ready to be written
 __bit CDC_ready(void) {
-  return(!CDC_writeBusyFlag);
+  return(!SPSC_full(CDC_TX));
+}
+
+// Load next packet from TX queue into EP2 IN buffer. Only full packets are sent,
+// unless a flush was requested. Called by the EP2 IN interrupt while busy, or by the
+// front end functions while not busy, so it never runs twice at the same time.
+static void CDC_TX_send(void) {
+  uint8_t len = SPSC_count(CDC_TX);
+  uint8_t left, n, i;
+  __xdata uint8_t* src;
+  __xdata uint8_t* dst = EP2_buffer + 64;
+  if(len > EP2_SIZE) len = EP2_SIZE;
+  if(!len || ((len < EP2_SIZE) && !CDC_flushFlag)) {    // nothing to send now?
+    if(!len) CDC_flushFlag = 0;                         // nothing left to flush
+    CDC_writeBusyFlag = 0;                              // go idle
+    return;
+  }
+  left = len;
+  while(left) {                                         // copy packet (max 2 parts)
+    n = SPSC_readLen(CDC_TX);
+    if(n > left) n = left;
+    left -= n;
+    src = SPSC_readPtr(CDC_TX);
+    for(i = n; i; i--) *dst++ = *src++;
+    SPSC_consume(CDC_TX, n);
+  }
+  if(SPSC_empty(CDC_TX)) CDC_flushFlag = 0;             // flush completed
+  CDC_writeBusyFlag = 1;                                // busy for now
+  UEP2_T_LEN = len;                                     // number of bytes in packet
+  UEP2_CTRL  = UEP2_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_ACK; // respond ACK
 }
 
 // Flush the OUT buffer
 void CDC_flush(void) {
-  if(!CDC_writeBusyFlag && CDC_writePointer > 0) {      // not busy and buffer not empty?
-    UEP2_T_LEN = CDC_writePointer;                      // number of bytes in OUT buffer
-    UEP2_CTRL  = UEP2_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_ACK; // respond ACK
-    CDC_writeBusyFlag = 1;                              // busy for now
-    CDC_writePointer  = 0;                              // reset write pointer
-  }
+  CDC_flushFlag = 1;                                    // send partial packet too
+  if(!CDC_writeBusyFlag) CDC_TX_send();                 // start if idle
 }
 
 // Write single character to OUT buffer
 void CDC_write(char c) {
-  while(CDC_writeBusyFlag);                             // wait for ready to write
-  EP2_buffer[64 + CDC_writePointer++] = c;              // write character
-  if(CDC_writePointer == EP2_SIZE) CDC_flush();         // flush if buffer full
+  while(SPSC_full(CDC_TX));                             // wait for ready to write
+  SPSC_put(CDC_TX, c);                                  // write character
+  if(!CDC_writeBusyFlag && (SPSC_count(CDC_TX) >= EP2_SIZE))
+    CDC_TX_send();                                      // send if full packet is ready
 }
 
 // Write string to OUT buffer
@@ -84,10 +117,13 @@ void CDC_println(char* str) {
 // Read single character from IN buffer
 char CDC_read(void) {
   char data;
-  while(!CDC_readByteCount);                            // wait for data
-  data = EP2_buffer[CDC_readPointer++];                 // get character
-  if(--CDC_readByteCount == 0)                          // dec number of bytes in buffer
-    UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_R_RES | UEP_R_RES_ACK;// request new data if empty
+  while(SPSC_empty(CDC_RX));                            // wait for data
+  data = SPSC_peek(CDC_RX);                             // get character
+  SPSC_consume(CDC_RX, 1);                              // remove it from queue
+  if(CDC_readStallFlag && (SPSC_free(CDC_RX) >= EP2_SIZE)) { // room for next packet?
+    CDC_readStallFlag = 0;
+    UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_R_RES | UEP_R_RES_ACK;// request new data
+  }
   return data;
 }
 
@@ -112,8 +148,11 @@ void CDC_setup(void) {
 void CDC_reset(void) {
   UEP1_CTRL = bUEP_AUTO_TOG | UEP_T_RES_NAK;
   UEP2_CTRL = bUEP_AUTO_TOG | UEP_T_RES_NAK | UEP_R_RES_ACK;
-  CDC_readByteCount = 0;                    // reset received bytes counter
+  SPSC_reset(CDC_RX);                       // empty RX queue
+  SPSC_reset(CDC_TX);                       // empty TX queue
+  CDC_readStallFlag = 0;                    // reset read stall flag
   CDC_writeBusyFlag = 0;                    // reset write busy flag
+  CDC_flushFlag     = 0;                    // reset flush flag
 }
 
 // Handle non-standard control requests
@@ -164,15 +203,28 @@ void CDC_EP1_IN(void) {
 void CDC_EP2_IN(void) {
   UEP2_T_LEN = 0;                                           // no data to send anymore
   UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_T_RES | UEP_T_RES_NAK;  // respond NAK by default
-  CDC_writeBusyFlag = 0;                                    // clear busy flag
+  CDC_TX_send();                                            // next packet or go idle
 }
 
 // Endpoint 2 OUT handler (bulk data transfer from host)
 void CDC_EP2_OUT(void) {
+  uint8_t len, n, i;
+  __xdata uint8_t* src = EP2_buffer;
+  __xdata uint8_t* dst;
   if(U_TOG_OK) {                                        // discard unsynchronized packets
-    CDC_readByteCount = USB_RX_LEN;                     // set number of received data bytes
-    CDC_readPointer = 0;                                // reset read pointer for fetching
-    if(CDC_readByteCount) 
-      UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_R_RES | UEP_R_RES_NAK; // respond NAK after a packet. Let main code change response after handling.
+    len = USB_RX_LEN;                                   // number of received data bytes
+    while(len) {                                        // copy packet into RX queue
+      n = SPSC_writeLen(CDC_RX);                        // (max 2 parts, there is always
+      if(!n) break;                                     // room for a full packet)
+      if(n > len) n = len;
+      len -= n;
+      dst = SPSC_writePtr(CDC_RX);
+      for(i = n; i; i--) *dst++ = *src++;
+      SPSC_commit(CDC_RX, n);
+    }
+    if(SPSC_free(CDC_RX) < EP2_SIZE) {                  // no room for next packet?
+      CDC_readStallFlag = 1;                            // CDC_read will release it
+      UEP2_CTRL = UEP2_CTRL & ~MASK_UEP_R_RES | UEP_R_RES_NAK; // respond NAK for now
+    }
   }
 }
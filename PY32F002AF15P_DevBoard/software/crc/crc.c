@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Example for PY32F0xx
-// Version:   v1.0
+// Version:   v1.2
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -12,6 +12,10 @@
 // ------------
 // Send a message through UART with a newline at the end, and the CRC of the message 
 // will be sent back. We're checking if the CRC module works.
+// On startup, the CRC32 over the whole application image in flash is calculated
+// with a table-driven software CRC, with the CRC module fed by the CPU and with
+// CRC_computeBlock() (include/crc.h), which uses DMA if CRC_DMA_CHANNEL is set on
+// parts with DMA. Results and times are sent via UART.
 //
 // Compilation Instructions:
 // -------------------------
@@ -29,6 +33,79 @@
 // ===================================================================================
 #include "system.h"                 // for system functions
 #include "uart.h"                   // for UART
+#include "crc.h"                    // for CRC over memory blocks
+
+// ===================================================================================
+// Table-Driven Software CRC32 (same algorithm as CRC module: CRC-32/MPEG-2)
+// ===================================================================================
+uint32_t SOFT_table[256];
+
+// Create lookup table
+void SOFT_init(void) {
+  uint32_t crc;
+  uint16_t i;
+  uint8_t  j;
+  for(i = 0; i < 256; i++) {
+    crc = (uint32_t)i << 24;
+    for(j = 8; j; j--) crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+    SOFT_table[i] = crc;
+  }
+}
+
+// Calculate CRC32 over len bytes (multiple of 4), words are processed MSB first
+uint32_t SOFT_compute(const uint32_t* ptr, uint32_t len) {
+  uint32_t crc = 0xFFFFFFFF;
+  uint32_t word;
+  uint8_t  i;
+  for(len >>= 2; len; len--) {
+    word = *ptr++;
+    for(i = 4; i; i--, word <<= 8) crc = (crc << 8) ^ SOFT_table[(crc >> 24) ^ (word >> 24)];
+  }
+  return crc;
+}
+
+// ===================================================================================
+// CRC Benchmark
+// ===================================================================================
+#define BENCH_start()     {SysTick->LOAD = 0xFFFFFF; SysTick->VAL = 0;}
+#define BENCH_ticks()     ((0xFFFFFF - SysTick->VAL) & 0xFFFFFF)
+
+// Print result and time of one method
+void BENCH_print(const char* name, uint32_t crc, uint32_t ticks) {
+  UART_print(name);
+  UART_printW(crc);
+  UART_print("  ");
+  UART_printD(ticks / DLY_US_TIME);
+  UART_println(" us");
+}
+
+// Calculate CRC over application image with all methods
+void BENCH_run(void) {
+  uint32_t size = CRC_imageSize() & ~3;
+  uint32_t crc, ticks;
+
+  UART_print("Image size:      ");
+  UART_printD(size);
+  UART_println(" bytes");
+
+  SOFT_init();
+  BENCH_start();
+  crc = SOFT_compute((const uint32_t*)FLASH_BASE, size);
+  ticks = BENCH_ticks();
+  BENCH_print("Software table:  ", crc, ticks);
+
+  BENCH_start();
+  CRC_reset();
+  for(crc = 0; crc < (size >> 2); crc++) CRC_write(((const uint32_t*)FLASH_BASE)[crc]);
+  crc = CRC_read();
+  ticks = BENCH_ticks();
+  BENCH_print("CRC unit, CPU:   ", crc, ticks);
+
+  BENCH_start();
+  crc = CRC_computeBlock((const void*)FLASH_BASE, size);
+  ticks = BENCH_ticks();
+  BENCH_print(CRC_usesDMA() ? "CRC unit, DMA:   " : "CRC unit, no DMA:", crc, ticks);
+}
 
 // ===================================================================================
 // Main Function
@@ -36,7 +113,9 @@
 int main (void) {
   // Setup
   UART_init();                      // init UART, 8N1, BAUD: 115200, PA2/PA3
-  CRC_enable();                     // enable CRC module
+  CRC_init();                       // enable CRC module (and DMA)
+  BENCH_run();                      // compare CRC methods over firmware image
+  CRC_reset();                      // start new calculation for messages
 
   // Loop
   while(1) {
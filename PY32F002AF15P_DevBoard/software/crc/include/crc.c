@@ -0,0 +1,106 @@
+// ===================================================================================
+// Hardware CRC32 over Memory Blocks with DMA for PY32F0xx                    * v1.1 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "crc.h"
+
+uint8_t CRC_DMA_used = 0;                               // last calculation by DMA
+
+// Image boundaries from linker script
+extern uint32_t _data_lma;
+extern uint32_t _data_vma;
+extern uint32_t _edata;
+
+// Enable CRC module (and DMA module)
+void CRC_init(void) {
+  CRC_enable();
+  #if CRC_DMA_CHANNEL > 0
+  RCC->AHBENR |= RCC_AHBENR_DMAEN;
+  #endif
+}
+
+// Feed words into CRC data register by CPU
+static void CRC_feedPolled(const uint32_t* ptr, uint32_t words) {
+  while(words >= 4) {                                   // unrolled by 4
+    CRC->DR = ptr[0];
+    CRC->DR = ptr[1];
+    CRC->DR = ptr[2];
+    CRC->DR = ptr[3];
+    ptr   += 4;
+    words -= 4;
+  }
+  while(words--) CRC->DR = *ptr++;
+}
+
+#if CRC_DMA_CHANNEL > 0
+// Feed words into CRC data register by DMA memory-to-memory transfer, the source is
+// the "peripheral" side (incremented), the CRC data register the memory side (fixed).
+// Returns 0 if the DMA channel does not respond as expected or failed.
+static uint8_t CRC_feedDMA(const uint32_t* ptr, uint32_t words) {
+  uint32_t cnt, flags;
+  while(words) {
+    cnt = (words > 0xFFFF) ? 0xFFFF : words;
+    CRC_DMA_CHAN->CCR   = 0;
+    DMA1->IFCR          = DMA_IFCR_CGIF1 << CRC_DMA_SHIFT;
+    CRC_DMA_CHAN->CPAR  = (uint32_t)ptr;
+    CRC_DMA_CHAN->CMAR  = (uint32_t)&CRC->DR;
+    CRC_DMA_CHAN->CNDTR = cnt;
+    if(CRC_DMA_CHAN->CNDTR != cnt) return 0;            // sanity check failed
+    CRC_DMA_CHAN->CCR   = DMA_CCR_MEM2MEM               // memory to memory
+                        | DMA_CCR_PL                    // very high priority
+                        | DMA_CCR_MSIZE_1               // 32-bit destination
+                        | DMA_CCR_PSIZE_1               // 32-bit source
+                        | DMA_CCR_PINC                  // increment source address
+                        | DMA_CCR_EN;                   // start transfer
+    do {
+      flags = DMA1->ISR >> CRC_DMA_SHIFT;
+    } while(!(flags & (DMA_ISR_TCIF1 | DMA_ISR_TEIF1)));
+    CRC_DMA_CHAN->CCR = 0;
+    DMA1->IFCR        = DMA_IFCR_CGIF1 << CRC_DMA_SHIFT;
+    if(flags & DMA_ISR_TEIF1) return 0;                 // bus error
+    ptr   += cnt;
+    words -= cnt;
+  }
+  return 1;
+}
+#endif
+
+// Calculate CRC32 over len bytes starting at ptr (must be word aligned)
+uint32_t CRC_computeBlock(const void* ptr, uint32_t len) {
+  const uint32_t* src = (const uint32_t*)ptr;
+  uint32_t words = len >> 2;
+  uint32_t last;
+  uint8_t  i;
+
+  // Feed all full words
+  CRC_reset();
+  CRC_DMA_used = 0;
+  #if CRC_DMA_CHANNEL > 0
+  CRC_DMA_used = CRC_feedDMA(src, words);
+  if(!CRC_DMA_used) {
+    CRC_reset();                                        // start over with CPU
+    CRC_feedPolled(src, words);
+  }
+  #else
+  CRC_feedPolled(src, words);
+  #endif
+
+  // Feed remaining bytes padded with 0xFF
+  if(len & 3) {
+    last = 0xFFFFFFFF;
+    for(i = 0; i < (len & 3); i++) ((uint8_t*)&last)[i] = ((const uint8_t*)(src + words))[i];
+    CRC->DR = last;
+  }
+  return CRC_read();
+}
+
+// Get size of application image in CODE FLASH (code, constants and .data init values)
+uint32_t CRC_imageSize(void) {
+  return (uint32_t)&_data_lma + ((uint32_t)&_edata - (uint32_t)&_data_vma) - FLASH_BASE;
+}
+
+// Calculate CRC32 over application image in CODE FLASH
+uint32_t CRC_computeFlash(void) {
+  return CRC_computeBlock((const void*)FLASH_BASE, CRC_imageSize());
+}
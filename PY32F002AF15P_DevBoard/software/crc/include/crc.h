@@ -0,0 +1,60 @@
+// ===================================================================================
+// Hardware CRC32 over Memory Blocks with DMA for PY32F0xx                    * v1.1 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// CRC_init()               Enable CRC module (and DMA module, if used)
+// CRC_computeBlock(p,n)    Calculate CRC32 over n bytes starting at p (word aligned)
+// CRC_computeFlash()       Calculate CRC32 over application image in CODE FLASH
+// CRC_imageSize()          Get size of application image in bytes (.text + .data)
+// CRC_usesDMA()            Check if last calculation was done by DMA
+//
+// The CRC module calculates CRC-32/MPEG-2 (polynomial 0x04C11DB7, initial value
+// 0xFFFFFFFF, no reflection, no final XOR) over 32-bit words, each word is processed
+// MSB first. If n is not a multiple of 4, the last word is padded with 0xFF bytes
+// (like erased flash). Since there is no final XOR, appending the resulting CRC as
+// one more word gives a CRC of 0, which makes a simple image self-check possible.
+//
+// By default (CRC_DMA_CHANNEL 0), the words are fed into the CRC data register by the
+// CPU. The PY32F002A has no documented DMA, and accessing its registers may cause a
+// HardFault, so DMA is opt-in: on parts with DMA (PY32F003, PY32F030), set
+// CRC_DMA_CHANNEL to 1 - 3 to feed the words by a DMA memory-to-memory transfer, which
+// needs one bus transfer per word and no CPU load. If the DMA channel does not take
+// the transfer count or reports a transfer error, the polled method is used instead.
+// The DMA channel must not be used by other code at the same time.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// CRC parameters
+#define CRC_DMA_CHANNEL       0         // DMA channel (1 - 3), 0: polled only
+
+// CRC functions
+void CRC_init(void);                                    // enable CRC (and DMA)
+uint32_t CRC_computeBlock(const void* ptr, uint32_t len); // CRC32 over n bytes
+uint32_t CRC_computeFlash(void);                        // CRC32 over image in flash
+uint32_t CRC_imageSize(void);                           // size of image in flash
+extern uint8_t CRC_DMA_used;
+#define CRC_usesDMA()         (CRC_DMA_used)            // last calculation by DMA
+
+// DMA channel defines
+#if   CRC_DMA_CHANNEL == 1
+  #define CRC_DMA_CHAN        DMA1_Channel1
+#elif CRC_DMA_CHANNEL == 2
+  #define CRC_DMA_CHAN        DMA1_Channel2
+#elif CRC_DMA_CHANNEL == 3
+  #define CRC_DMA_CHAN        DMA1_Channel3
+#endif
+#define CRC_DMA_SHIFT         ((CRC_DMA_CHANNEL - 1) << 2)
+
+#ifdef __cplusplus
+};
+#endif
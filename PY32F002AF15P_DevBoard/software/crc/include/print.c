@@ -1,29 +1,144 @@
 // ===================================================================================
-// Basic PRINT Functions                                                      * v1.0 *
+// Basic PRINT Functions                                                      * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #include "print.h"
 
-// For BCD conversion
-const uint32_t DIVIDER[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
-                            10000000, 100000000, 1000000000};
+// ===================================================================================
+// Number Formatting
+// ===================================================================================
 
-// Print decimal value (BCD conversion by substraction method)
-void printD(uint32_t value, void (*putchar) (char c)) {
-  uint8_t digits   = 10;                          // print 10 digits
-  uint8_t leadflag = 0;                           // flag for leading spaces
-  while(digits--) {                               // for all digits
-    uint8_t digitval = 0;                         // start with digit value 0
-    uint32_t divider = DIVIDER[digits];           // read current divider
-    while(value >= divider) {                     // if current divider fits into the value
-      leadflag = 1;                               // end of leading spaces
-      digitval++;                                 // increase digit value
-      value -= divider;                           // decrease value by divider
-    }
-    if(!digits)  leadflag++;                      // least digit has to be printed
-    if(leadflag) putchar(digitval + '0');         // print the digit
+// Two-digit lookup table for decimal conversion
+static const char FMT_DIGITS[200] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+// Hex digits
+static const char FMT_HEX[16] = "0123456789ABCDEF";
+
+// Multiply by 100 using shifts and adds (no multiplier needed)
+#define FMT_MUL100(q)   (((q) << 6) + ((q) << 5) + ((q) << 2))
+
+// Divide by 100 (reciprocal multiplication, Hacker's Delight divu100 without multiplier)
+static inline uint32_t FMT_div100(uint32_t n) {
+  #if FMT_MULDIV == 1
+  return (uint32_t)(((uint64_t)n * 0x51EB851FUL) >> 37);
+  #else
+  uint32_t q = (n >> 1) + (n >> 3) + (n >> 6) - (n >> 10) + (n >> 12) + (n >> 13) - (n >> 16);
+  q += (q >> 20);
+  q >>= 6;
+  return q + ((n - FMT_MUL100(q) + 28) >> 7);
+  #endif
+}
+
+// Convert unsigned value into decimal digits backwards from end, return start
+static char* FMT_utoa(char* end, uint32_t value) {
+  const char* d;
+  while(value >= 100) {                           // two digits per division
+    uint32_t q = FMT_div100(value);
+    d = &FMT_DIGITS[(value - FMT_MUL100(q)) << 1];
+    *--end = d[1];
+    *--end = d[0];
+    value = q;
+  }
+  if(value >= 10) {                               // last two digits
+    d = &FMT_DIGITS[value << 1];
+    *--end = d[1];
+    *--end = d[0];
   }
+  else *--end = '0' + value;                      // last single digit
+  return end;
+}
+
+// Copy digits with sign and padding into buffer, return length
+static uint8_t FMT_pad(char* buf, const char* str, uint8_t len, char sign, uint8_t width, uint8_t flags) {
+  char* ptr = buf;
+  uint8_t total = len + (sign ? 1 : 0);
+  uint8_t pad   = (width > total) ? (width - total) : 0;
+  if(!(flags & FMT_ZERO)) while(pad) {*ptr++ = ' '; pad--;}
+  if(sign) *ptr++ = sign;
+  while(pad) {*ptr++ = '0'; pad--;}
+  while(len--) *ptr++ = *str++;
+  *ptr = 0;
+  return ptr - buf;
+}
+
+// Format unsigned decimal value
+uint8_t fmtU(char* buf, uint32_t value, uint8_t width, uint8_t flags) {
+  char tmp[FMT_BUF_SIZE];
+  char* str = FMT_utoa(tmp + FMT_BUF_SIZE, value);
+  return FMT_pad(buf, str, tmp + FMT_BUF_SIZE - str, 0, width, flags);
+}
+
+// Format signed decimal value
+uint8_t fmtI(char* buf, int32_t value, uint8_t width, uint8_t flags) {
+  char tmp[FMT_BUF_SIZE];
+  uint32_t mag = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+  char* str = FMT_utoa(tmp + FMT_BUF_SIZE, mag);
+  return FMT_pad(buf, str, tmp + FMT_BUF_SIZE - str, (value < 0) ? '-' : 0, width, flags);
+}
+
+// Format signed fixed-point value with decimals
+uint8_t fmtF(char* buf, int32_t value, uint8_t decimals, uint8_t width, uint8_t flags) {
+  char tmp[FMT_BUF_SIZE];
+  char* end = tmp + FMT_BUF_SIZE;
+  uint32_t mag = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+  char* str = FMT_utoa(end, mag);
+  if(decimals > 9) decimals = 9;
+  if(decimals) {
+    while(end - str <= decimals) *--str = '0';    // at least one integer digit
+    char* dst = --str;                            // shift integer part left
+    char* dot = end - decimals;
+    while(dst < dot - 1) {*dst = dst[1]; dst++;}
+    *dst = '.';                                   // insert decimal point
+  }
+  return FMT_pad(buf, str, end - str, (value < 0) ? '-' : 0, width, flags);
+}
+
+// Format hex value with fixed number of digits
+uint8_t fmtX(char* buf, uint32_t value, uint8_t digits) {
+  if(digits > 8) digits = 8;
+  if(!digits) digits = 1;
+  buf[digits] = 0;
+  for(uint8_t i = digits; i; i--) {
+    buf[i - 1] = FMT_HEX[value & 0x0f];
+    value >>= 4;
+  }
+  return digits;
+}
+
+// ===================================================================================
+// Print Functions
+// ===================================================================================
+
+// Print decimal value
+void printD(uint32_t value, void (*putchar) (char c)) {
+  char buf[FMT_BUF_SIZE];
+  fmtU(buf, value, 0, 0);
+  printS(buf, putchar);
+}
+
+// Print signed decimal value
+void printI(int32_t value, void (*putchar) (char c)) {
+  char buf[FMT_BUF_SIZE];
+  fmtI(buf, value, 0, 0);
+  printS(buf, putchar);
+}
+
+// Print signed fixed-point value with decimals
+void printF(int32_t value, uint8_t decimals, void (*putchar) (char c)) {
+  char buf[FMT_BUF_SIZE];
+  fmtF(buf, value, decimals, 0, 0);
+  printS(buf, putchar);
 }
 
 // Convert 4-bit byte nibble into hex character and print it via putchar
@@ -59,3 +174,56 @@ void println(const char* str, void (*putchar) (char c)) {
   while(*str) putchar(*str++);
   putchar('\n');
 }
+
+// ===================================================================================
+// Block-Write Functions
+// ===================================================================================
+
+// Write decimal value via block-write sink
+void writeD(uint32_t value, PRINT_SINK_t write) {
+  char buf[FMT_BUF_SIZE];
+  write(buf, fmtU(buf, value, 0, 0));
+}
+
+// Write signed decimal value via block-write sink
+void writeI(int32_t value, PRINT_SINK_t write) {
+  char buf[FMT_BUF_SIZE];
+  write(buf, fmtI(buf, value, 0, 0));
+}
+
+// Write signed fixed-point value with decimals via block-write sink
+void writeF(int32_t value, uint8_t decimals, PRINT_SINK_t write) {
+  char buf[FMT_BUF_SIZE];
+  write(buf, fmtF(buf, value, decimals, 0, 0));
+}
+
+// Write 8-bit byte as hex characters via block-write sink
+void writeB(uint8_t value, PRINT_SINK_t write) {
+  char buf[3];
+  write(buf, fmtX(buf, value, 2));
+}
+
+// Write 16-bit half-word as hex characters via block-write sink
+void writeH(uint16_t value, PRINT_SINK_t write) {
+  char buf[5];
+  write(buf, fmtX(buf, value, 4));
+}
+
+// Write 32-bit word as hex characters via block-write sink
+void writeW(uint32_t value, PRINT_SINK_t write) {
+  char buf[9];
+  write(buf, fmtX(buf, value, 8));
+}
+
+// Write string via block-write sink
+void writeS(const char* str, PRINT_SINK_t write) {
+  const char* end = str;
+  while(*end) end++;
+  write(str, end - str);
+}
+
+// Write string with newline via block-write sink
+void writeln(const char* str, PRINT_SINK_t write) {
+  writeS(str, write);
+  write("\n", 1);
+}
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for PY32F0xx                                  * v1.0 *
+// Basic Serial Debug Functions for PY32F0xx                                  * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -118,25 +118,26 @@ void DEBUG_println(const char* str) {
   DEBUG_write('\n');
 }
 
-// For BCD conversion
-const uint32_t DIVIDER[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
-                            10000000, 100000000, 1000000000};
+// Divide by 10 using shifts and adds (no hardware divider/multiplier needed)
+static inline uint32_t DEBUG_div10(uint32_t n) {
+  uint32_t q = (n >> 1) + (n >> 2);
+  q += (q >> 4);
+  q += (q >> 8);
+  q += (q >> 16);
+  q >>= 3;
+  return q + ((n - (((q << 2) + q) << 1)) > 9);
+}
 
-// Print decimal value (BCD conversion by substraction method)
+// Print decimal value (BCD conversion by reciprocal division)
 void DEBUG_printD(uint32_t value) {
-  uint8_t digits   = 10;                          // print 10 digits
-  uint8_t leadflag = 0;                           // flag for leading spaces
-  while(digits--) {                               // for all digits digits
-    uint8_t digitval = 0;                         // start with digit value 0
-    uint32_t divider = DIVIDER[digits];           // read current divider
-    while(value >= divider) {                     // if current divider fits into the value
-      leadflag = 1;                               // end of leading spaces
-      digitval++;                                 // increase digit value
-      value -= divider;                           // decrease value by divider
-    }
-    if(!digits)  leadflag++;                      // least digit has to be printed
-    if(leadflag) DEBUG_write(digitval + '0');     // print the digit
-  }
+  char buf[10];                                   // max 10 digits
+  uint8_t len = 0;                                // number of digits
+  do {                                            // for all digits
+    uint32_t q = DEBUG_div10(value);              // divide by 10
+    buf[len++] = value - (((q << 2) + q) << 1);   // remainder is digit value
+    value = q;                                    // continue with quotient
+  } while(value);                                 // until no digits left
+  while(len) DEBUG_write(buf[--len] + '0');       // print digits in right order
 }
 
 // Convert 4-bit byte nibble into hex character and print it via UART
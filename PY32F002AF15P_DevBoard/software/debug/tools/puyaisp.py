@@ -1,7 +1,7 @@
 #!/usr/bin/env python3
 # ===================================================================================
 # Project:   puyaisp - Programming Tool for PUYA PY32F0xx Microcontrollers
-# Version:   v1.3
+# Version:   v1.5
 # Year:      2023
 # Author:    Stefan Wagner
 # Github:    https://github.com/wagiminator
@@ -40,6 +40,11 @@
 #   your board has them).
 #
 # Run "python3 puyaisp.py -f firmware.bin".
+# Run "python3 puyaisp.py -d -f firmware.bin" to only erase and write the pages that
+# differ from the firmware already in flash (much faster for small changes). Pages
+# behind the new firmware which are not blank (e.g. the end of a larger old firmware)
+# are erased as well. If the bootloader rejects page erase, a chip erase with a full
+# write is done instead.
 
 # If the PID/VID of the USB-to-Serial converter is known, it can be defined here,
 # which can make the auto-detection a lot faster. If not, comment out or delete.
@@ -69,6 +74,7 @@ def _main():
     parser.add_argument('-o', '--rstoption',action='store_true', help='reset option bytes')
     parser.add_argument('-G', '--nrstgpio', action='store_true', help='make nRST pin a GPIO pin')
     parser.add_argument('-R', '--nrstreset',action='store_true', help='make nRST pin a RESET pin')
+    parser.add_argument('-d', '--diff',     action='store_true', help='only erase and write changed pages (with -f)')
     parser.add_argument('-f', '--flash',    help='write BIN file to flash and verify')
     args = parser.parse_args(sys.argv[1:])
 
@@ -112,19 +118,29 @@ def _main():
         print('SUCCESS:', isp.optionstr + '.')
 
         # Perform chip erase
-        if (args.erase) or (args.flash is not None):
+        if (args.erase) or (args.flash is not None and not args.diff):
             print('Performing chip erase ...')
             isp.erase()
             print('SUCCESS: Chip is erased.')
 
         # Flash binary file
         if args.flash is not None:
-            print('Flashing', args.flash, 'to MCU ...')
             with open(args.flash, 'rb') as f: data = f.read()
-            isp.writeflash(PY_CODE_ADDR, data)
-            print('Verifying ...')
-            isp.verifyflash(PY_CODE_ADDR, data)
-            print('SUCCESS:', len(data), 'bytes written and verified.')
+            if args.diff:
+                print('Comparing', args.flash, 'with flash ...')
+                pages = isp.comparepages(PY_CODE_ADDR, data)
+                print('Erasing and writing %d changed or stale pages ...' % len(pages))
+                if isp.diffflash(PY_CODE_ADDR, data, pages):
+                    print('SUCCESS:', len(data), 'bytes compared, changed pages written and verified.')
+                else:
+                    print('WARNING: Page erase was rejected, chip erase and full write performed.')
+                    print('SUCCESS:', len(data), 'bytes written and verified.')
+            else:
+                print('Flashing', args.flash, 'to MCU ...')
+                isp.writeflash(PY_CODE_ADDR, data, skipblank = True)
+                print('Verifying ...')
+                isp.verifyflash(PY_CODE_ADDR, data)
+                print('SUCCESS:', len(data), 'bytes written and verified.')
 
         # Manipulate OPTION bytes (only for identified chips)
         if isp.pid == PY_CHIP_PID and any( (args.rstoption, args.nrstgpio, args.nrstreset, args.lock) ):
@@ -281,6 +297,26 @@ class Programmer(Serial):
         if not self.checkreply():
             raise Exception('Failed to erase chip')
 
+    # Erase pages (list of page numbers) in groups of up to PY_ERASE_PAGES pages,
+    # return False if the bootloader rejects the page erase command or frame
+    def erasepages(self, pages):
+        for i in range(0, len(pages), PY_ERASE_PAGES):
+            group  = pages[i:i + PY_ERASE_PAGES]
+            stream = (len(group) - 1).to_bytes(2, byteorder='big')
+            for page in group:
+                stream += page.to_bytes(2, byteorder='big')
+            parity = 0x00
+            for x in stream:
+                parity ^= x
+            self.write([PY_CMD_ERASE, PY_CMD_ERASE ^ 0xff])
+            if not self.checkreply():
+                return False
+            self.write(stream)
+            self.write([parity])
+            if not self.checkreply():
+                return False
+        return True
+
     # Read flash
     def readflash(self, addr, size):
         data = bytes()
@@ -295,13 +331,18 @@ class Programmer(Serial):
             size -= blocksize
         return data
 
-    # Write flash
-    def writeflash(self, addr, data):
+    # Write flash (blocks containing only 0xff can be skipped on erased flash)
+    def writeflash(self, addr, data, skipblank = False):
         size = len(data)
         while size > 0:
             blocksize = size
             if blocksize > PY_BLOCKSIZE: blocksize = PY_BLOCKSIZE
             block = data[:blocksize]
+            if skipblank and block == b'\xff' * blocksize:
+                data  = data[blocksize:]
+                addr += blocksize
+                size -= blocksize
+                continue
             parity = blocksize - 1
             for x in range(blocksize):
                 parity ^= block[x]
@@ -319,9 +360,47 @@ class Programmer(Serial):
     # Verify flash
     def verifyflash(self, addr, data):
         flash = self.readflash(addr, len(data))
-        if set(flash) != set(data):
+        if flash != bytes(data):
             raise Exception('Verification failed')
 
+    #--------------------------------------------------------------------------------
+
+    # Read back flash and get list of page offsets which differ from data. The pages
+    # behind the data are read up to the end of flash (the bootloader rejects the
+    # address) and added if they are not blank, so no rest of an old firmware remains.
+    def comparepages(self, addr, data):
+        data  = data + b'\xff' * (-len(data) % PY_PAGESIZE)
+        flash = self.readflash(addr, len(data))
+        pages = [i for i in range(0, len(data), PY_PAGESIZE) \
+                   if flash[i:i + PY_PAGESIZE] != data[i:i + PY_PAGESIZE]]
+        i = len(data)
+        while addr + i < PY_FLASH_ADDR + PY_FLASH_MAX:
+            try:
+                page = self.readflash(addr + i, PY_PAGESIZE)
+            except:
+                break                           # end of flash reached
+            if page != b'\xff' * PY_PAGESIZE:
+                pages.append(i)
+            i += PY_PAGESIZE
+        return pages
+
+    # Erase and write changed pages only, pages containing only 0xff are just erased.
+    # Return False if page erase was rejected and chip erase with full write was done.
+    def diffflash(self, addr, data, pages):
+        size = max([len(data)] + [i + PY_PAGESIZE for i in pages])
+        data = data + b'\xff' * (size - len(data))
+        if not self.erasepages([(addr + i - PY_FLASH_ADDR) // PY_PAGESIZE for i in pages]):
+            self.erase()
+            self.writeflash(addr, data, skipblank = True)
+            self.verifyflash(addr, data)
+            return False
+        for i in pages:
+            page = data[i:i + PY_PAGESIZE]
+            if page != b'\xff' * PY_PAGESIZE:
+                self.writeflash(addr + i, page)
+            self.verifyflash(addr + i, page)
+        return True
+
 # ===================================================================================
 # Device Constants
 # ===================================================================================
@@ -329,6 +408,9 @@ class Programmer(Serial):
 # Device and Memory constants
 PY_CHIP_PID     = 0x440
 PY_BLOCKSIZE    = 128
+PY_PAGESIZE     = 128
+PY_ERASE_PAGES  = 32
+PY_FLASH_MAX    = 0x10000
 PY_FLASH_ADDR   = 0x08000000
 PY_CODE_ADDR    = 0x08000000
 PY_SRAM_ADDR    = 0x20000000
@@ -1,16 +1,43 @@
 // ===================================================================================
-// Basic PRINT Functions                                                      * v1.0 *
+// Basic PRINT Functions                                                      * v1.2 *
 // ===================================================================================
 //
 // Functions available:
 // --------------------
 // printD(n, putchar)       Print decimal value as string via putchar function
+// printI(n, putchar)       Print signed decimal value as string via putchar function
+// printF(n, d, putchar)    Print fixed-point value n with d decimals (e.g. mV -> V)
 // printW(n, putchar)       Print 32-bit hex word value as string via putchar function
 // printH(n, putchar)       Print 16-bit hex half-word value as string via putchar function
 // printB(n, putchar)       Print  8-bit hex byte value as string via putchar function
 // printS(s, putchar)       Print string via putchar function
 // println(s, putchar)      Print string with newline via putchar function
 //
+// Formatting functions (write into caller buffer of at least FMT_BUF_SIZE bytes or
+// width + 1 bytes, string is zero-terminated, return number of characters):
+// fmtU(buf, n, w, f)       Format unsigned decimal value n, minimum width w, flags f
+// fmtI(buf, n, w, f)       Format signed decimal value n, minimum width w, flags f
+// fmtF(buf, n, d, w, f)    Format signed fixed-point value n with d decimals (d <= 9),
+//                          e.g. fmtF(buf, 3301, 3, 0, 0) -> "3.301"
+// fmtX(buf, n, d)          Format hex value n with d digits (d <= 8)
+//
+// Flags: FMT_ZERO          Pad with leading zeros instead of spaces
+//
+// Block-write functions (send the complete string with one call of the sink function
+// write(buf, len), so that DMA or batched drivers receive whole strings):
+// writeD(n, write)         Write decimal value as string via write function
+// writeI(n, write)         Write signed decimal value as string via write function
+// writeF(n, d, write)      Write fixed-point value n with d decimals via write function
+// writeW(n, write)         Write 32-bit hex word value as string via write function
+// writeH(n, write)         Write 16-bit hex half-word value as string via write function
+// writeB(n, write)         Write  8-bit hex byte value as string via write function
+// writeS(s, write)         Write string via write function
+// writeln(s, write)        Write string with newline via write function
+//
+// Decimal conversion uses reciprocal multiplication by 1/100 and a two-digit lookup
+// table. On cores without hardware multiplier (e.g. RV32EC, Cortex-M0+ without long
+// multiply) the reciprocal multiplication is done by shifts and adds.
+//
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #pragma once
@@ -21,13 +48,48 @@ extern "C" {
 
 #include <stdint.h>
 
+// Formatting parameters
+#define FMT_BUF_SIZE  16        // minimum buffer size for formatting functions
+#define FMT_ZERO      0x01      // flag: pad with leading zeros
+
+// Select division method
+#ifndef FMT_MULDIV
+  #if defined(__riscv_mul) || !(defined(__riscv) || defined(__arm__))
+    #define FMT_MULDIV  1       // 64-bit multiply is cheap
+  #else
+    #define FMT_MULDIV  0       // use shifts and adds
+  #endif
+#endif
+
+// Block-write sink function type
+typedef void (*PRINT_SINK_t)(const char* buf, uint16_t len);
+
+// Formatting functions
+uint8_t fmtU(char* buf, uint32_t value, uint8_t width, uint8_t flags);
+uint8_t fmtI(char* buf, int32_t value, uint8_t width, uint8_t flags);
+uint8_t fmtF(char* buf, int32_t value, uint8_t decimals, uint8_t width, uint8_t flags);
+uint8_t fmtX(char* buf, uint32_t value, uint8_t digits);
+
+// Print functions
 void printD(uint32_t value, void (*putchar) (char c));
+void printI(int32_t value, void (*putchar) (char c));
+void printF(int32_t value, uint8_t decimals, void (*putchar) (char c));
 void printB(uint8_t value, void (*putchar) (char c));
 void printH(uint16_t value, void (*putchar) (char c));
 void printW(uint32_t value, void (*putchar) (char c));
 void printS(const char* str, void (*putchar) (char c));
 void println(const char* str, void (*putchar) (char c));
 
+// Block-write functions
+void writeD(uint32_t value, PRINT_SINK_t write);
+void writeI(int32_t value, PRINT_SINK_t write);
+void writeF(int32_t value, uint8_t decimals, PRINT_SINK_t write);
+void writeB(uint8_t value, PRINT_SINK_t write);
+void writeH(uint16_t value, PRINT_SINK_t write);
+void writeW(uint32_t value, PRINT_SINK_t write);
+void writeS(const char* str, PRINT_SINK_t write);
+void writeln(const char* str, PRINT_SINK_t write);
+
 #ifdef __cplusplus
 };
 #endif
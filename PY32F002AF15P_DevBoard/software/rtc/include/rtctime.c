@@ -0,0 +1,228 @@
+// ===================================================================================
+// RTC Timekeeping with Sub-Second Timestamps and Alarm Queue for PY32F0xx    * v1.1 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "rtctime.h"
+
+#define TIME_DAY          86400UL                       // seconds per day
+#define TIME_EPOCH_DAYS   719468UL                      // days 0000-03-01..1970-01-01
+
+// Alarm queue (binary min-heap ordered by alarm time)
+typedef struct {
+  uint32_t time;                                        // alarm time in seconds
+  uint32_t period;                                      // repeat period (0: once)
+  void (*func)(void);                                   // callback function
+  uint8_t  id;                                          // alarm id
+} TIME_alarm_t;
+
+static TIME_alarm_t TIME_heap[TIME_ALARMS];
+static uint8_t TIME_heapSize;                           // number of pending alarms
+static uint8_t TIME_lastId;                             // last assigned alarm id
+
+// ===================================================================================
+// Time Functions
+// ===================================================================================
+
+// Wait until RTC registers are synchronized (after reset or STOP mode)
+static void TIME_sync(void) {
+  if(RTC->CRL & RTC_CRL_RSF) return;
+  while(!(RTC->CRL & RTC_CRL_RSF));
+}
+
+// Init RTC with 1Hz counter clock, enable alarm interrupt and STOP wake-up
+void TIME_init(void) {
+  TIME_heapSize = 0;
+  TIME_lastId   = 0;
+  RTC_init();                                           // init RTC with LSI
+  RTC->CRL &= ~RTC_CRL_RSF;                             // resynchronize registers
+  TIME_sync();
+  RTC_setPrescaler(TIME_RTC_PRL);                       // 32768Hz / 32768 = 1Hz
+  RTC_setAlarm(0xFFFFFFFF);                             // no alarm yet
+  while(!(RTC->CRL & RTC_CRL_RTOFF));                   // wait until written
+  RTC->CRL &= ~RTC_CRL_ALRF;                            // clear alarm flag
+  RTC->CRH  = RTC_CRH_ALRIE;                            // enable alarm interrupt
+  EXTI->IMR |= EXTI_IMR_IM19;                           // RTC line: wake-up from STOP
+  NVIC_EnableIRQ(RTC_IRQn);                             // enable RTC interrupt
+}
+
+// Set time in seconds since epoch, reschedule alarms
+void TIME_set(uint32_t seconds) {
+  RTC_setCounter(seconds);
+  while(!(RTC->CRL & RTC_CRL_RTOFF));                   // wait until written
+  NVIC_SetPendingIRQ(RTC_IRQn);                         // set alarm for new time
+}
+
+// Get time in seconds since epoch
+uint32_t TIME_seconds(void) {
+  uint32_t cnt;
+  TIME_sync();
+  do cnt = RTC_getCounter(); while(cnt != RTC_getCounter());
+  return cnt;
+}
+
+// Get timestamp with sub-seconds (counter and divider from the same second)
+void TIME_get(TIME_stamp_t* stamp) {
+  uint32_t cnt;
+  uint16_t div;
+  TIME_sync();
+  do {
+    cnt = RTC_getCounter();
+    div = RTC->DIVL;                                    // DIVH is 0 (PRL < 65536)
+  } while(cnt != RTC_getCounter());
+  stamp->seconds = cnt;
+  stamp->sub     = (div > TIME_RTC_PRL) ? 0 : TIME_RTC_PRL - div;
+}
+
+// ===================================================================================
+// Calendar Functions (32-bit arithmetic, years start in March for leap days)
+// ===================================================================================
+
+// Convert seconds since epoch into calendar date
+void TIME_toDate(uint32_t seconds, TIME_date_t* date) {
+  uint32_t days = seconds / TIME_DAY;
+  uint32_t secs = seconds - days * TIME_DAY;
+  uint32_t era, doe, yoe, doy, mp;
+
+  date->weekday = (days + 4) % 7;                       // 1970-01-01 was a Thursday
+  date->hour    = secs / 3600;
+  secs         -= (uint32_t)date->hour * 3600;
+  date->minute  = secs / 60;
+  date->second  = secs - (uint32_t)date->minute * 60;
+
+  days += TIME_EPOCH_DAYS;                              // days since 0000-03-01
+  era   = days / 146097;                                // 400-year era
+  doe   = days - era * 146097;                          // day of era
+  yoe   = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // year of era
+  doy   = doe - (365 * yoe + yoe / 4 - yoe / 100);      // day of year (from March)
+  mp    = (5 * doy + 2) / 153;                          // month (0 = March)
+  date->day   = doy - (153 * mp + 2) / 5 + 1;
+  date->month = (mp < 10) ? mp + 3 : mp - 9;
+  date->year  = yoe + era * 400 + (date->month <= 2);
+}
+
+// Convert calendar date into seconds since epoch
+uint32_t TIME_fromDate(const TIME_date_t* date) {
+  uint32_t y = date->year - (date->month <= 2);
+  uint32_t era = y / 400;
+  uint32_t yoe = y - era * 400;
+  uint32_t doy = (153 * (date->month + ((date->month > 2) ? -3 : 9)) + 2) / 5 + date->day - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  uint32_t days = era * 146097 + doe - TIME_EPOCH_DAYS;
+  return days * TIME_DAY + (uint32_t)date->hour * 3600 + date->minute * 60 + date->second;
+}
+
+// ===================================================================================
+// Alarm Queue Functions
+// ===================================================================================
+
+// Check if alarm a is due before alarm b (wrap-around safe)
+#define TIME_before(a, b) ((int32_t)(TIME_heap[a].time - TIME_heap[b].time) < 0)
+
+// Swap two heap entries
+static void TIME_swap(uint8_t a, uint8_t b) {
+  TIME_alarm_t tmp = TIME_heap[a];
+  TIME_heap[a] = TIME_heap[b];
+  TIME_heap[b] = tmp;
+}
+
+// Move heap entry up until its parent is due earlier
+static void TIME_siftUp(uint8_t i) {
+  while(i && TIME_before(i, (i - 1) >> 1)) {
+    TIME_swap(i, (i - 1) >> 1);
+    i = (i - 1) >> 1;
+  }
+}
+
+// Move heap entry down until its children are due later
+static void TIME_siftDown(uint8_t i) {
+  uint8_t c;
+  while((c = 2 * i + 1) < TIME_heapSize) {
+    if((c + 1 < TIME_heapSize) && TIME_before(c + 1, c)) c++;
+    if(!TIME_before(c, i)) break;
+    TIME_swap(i, c);
+    i = c;
+  }
+}
+
+// Remove heap entry
+static void TIME_removeAt(uint8_t i) {
+  TIME_heap[i] = TIME_heap[--TIME_heapSize];
+  if(i < TIME_heapSize) {
+    TIME_siftUp(i);
+    TIME_siftDown(i);
+  }
+}
+
+// Call due alarms, set RTC alarm to the next one (called by RTC interrupt)
+static void TIME_service(void) {
+  TIME_alarm_t alarm;
+  uint32_t now;
+  while(TIME_heapSize) {
+    now = TIME_seconds();
+    if((int32_t)(TIME_heap[0].time - now) > 0) {
+      RTC_setAlarm(TIME_heap[0].time);                  // set RTC alarm to next one
+      while(!(RTC->CRL & RTC_CRL_RTOFF));               // wait until written
+      if((int32_t)(TIME_heap[0].time - TIME_seconds()) > 0) return;
+      continue;                                         // passed while writing
+    }
+    alarm = TIME_heap[0];                               // earliest alarm is due
+    if(alarm.period) {                                  // periodic: reschedule,
+      TIME_heap[0].time += ((now - alarm.time) / alarm.period + 1) * alarm.period;
+      TIME_siftDown(0);                                 // skip missed periods at once
+    }
+    else TIME_removeAt(0);                              // once: remove
+    alarm.func();                                       // call alarm function
+  }
+}
+
+// Add alarm at time in seconds since epoch, return alarm id (0: queue full)
+uint8_t TIME_alarmAt(uint32_t seconds, void (*func)(void), uint32_t period) {
+  uint8_t i, id = 0;
+  if(!func) return 0;
+  NVIC_DisableIRQ(RTC_IRQn);
+  if(TIME_heapSize < TIME_ALARMS) {
+    do {                                                // find unused id
+      if(!++TIME_lastId) TIME_lastId = 1;
+      for(i = 0; (i < TIME_heapSize) && (TIME_heap[i].id != TIME_lastId); i++);
+    } while(i < TIME_heapSize);
+    id = TIME_lastId;
+    i  = TIME_heapSize++;
+    TIME_heap[i].time   = seconds;
+    TIME_heap[i].period = period;
+    TIME_heap[i].func   = func;
+    TIME_heap[i].id     = id;
+    TIME_siftUp(i);
+    NVIC_SetPendingIRQ(RTC_IRQn);                       // update RTC alarm
+  }
+  NVIC_EnableIRQ(RTC_IRQn);
+  return id;
+}
+
+// Remove alarm, return 1 if it was found
+uint8_t TIME_alarmCancel(uint8_t id) {
+  uint8_t i, found = 0;
+  NVIC_DisableIRQ(RTC_IRQn);
+  for(i = 0; (i < TIME_heapSize) && (TIME_heap[i].id != id); i++);
+  if(id && (i < TIME_heapSize)) {
+    TIME_removeAt(i);
+    NVIC_SetPendingIRQ(RTC_IRQn);                       // update RTC alarm
+    found = 1;
+  }
+  NVIC_EnableIRQ(RTC_IRQn);
+  return found;
+}
+
+// Get number of pending alarms
+uint8_t TIME_alarmCount(void) {
+  return TIME_heapSize;
+}
+
+// ===================================================================================
+// RTC Interrupt Service Routine
+// ===================================================================================
+void RTC_IRQHandler(void) __attribute__((interrupt));
+void RTC_IRQHandler(void) {
+  RTC->CRL &= ~RTC_CRL_ALRF;                            // clear alarm flag
+  TIME_service();                                       // call due alarms
+}
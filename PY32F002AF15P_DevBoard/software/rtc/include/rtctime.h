@@ -0,0 +1,86 @@
+// ===================================================================================
+// RTC Timekeeping with Sub-Second Timestamps and Alarm Queue for PY32F0xx    * v1.1 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// TIME_init()              Init RTC (LSI, 1Hz), alarm interrupt and STOP wake-up
+// TIME_set(s)              Set time in seconds since 1970-01-01 00:00:00 (epoch)
+// TIME_seconds()           Get time in seconds since epoch
+// TIME_get(t)              Get timestamp (t) with seconds and sub-seconds (1/32768s)
+// TIME_subToMs(n)          Convert sub-seconds (n) into milliseconds
+//
+// TIME_toDate(s, d)        Convert seconds since epoch (s) into calendar date (d)
+// TIME_fromDate(d)         Convert calendar date (d) into seconds since epoch
+//
+// TIME_alarmAt(s, f, p)    Call function (f) at time (s) in seconds since epoch and
+//                          then every (p) seconds (0: once), return alarm id (0: full)
+// TIME_alarmIn(s, f, p)    Same as TIME_alarmAt, but (s) seconds from now
+// TIME_alarmCancel(id)     Remove alarm with id, return 1 if it was found
+// TIME_alarmCount()        Get number of pending alarms
+//
+// The RTC counter holds the seconds since epoch (valid until 2106). The sub-seconds
+// are taken from the RTC prescaler divider, which counts the 32768 LSI clock cycles
+// of each second down. Counter and divider are read until two readings of the counter
+// are equal, so the timestamp is consistent. After a wake-up from STOP mode (which
+// clears the RTC flags), the registers are resynchronized automatically.
+//
+// The calendar conversion uses the days-from-civil algorithm with 32-bit arithmetic
+// only (no 64-bit division, no tables). Weekday: 0 = Sunday .. 6 = Saturday.
+//
+// Any number of alarms (up to TIME_ALARMS) is multiplexed onto the single RTC alarm
+// register: the pending alarms are kept in a binary min-heap ordered by their time,
+// and the RTC alarm is always set to the earliest one. The alarm callbacks are called
+// in the RTC interrupt (even if an alarm was already due when it was added), so they
+// should be short. The RTC alarm also wakes up the device from STOP mode. Alarms have
+// a resolution of one second.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// TIME parameters
+#define TIME_ALARMS       8         // max number of pending alarms
+#define TIME_RTC_PRL      32767     // RTC prescaler (RTC clock / (PRL + 1) = 1Hz)
+
+// Timestamp
+typedef struct {
+  uint32_t seconds;                 // seconds since epoch
+  uint16_t sub;                     // sub-seconds in 1/(TIME_RTC_PRL + 1) s
+} TIME_stamp_t;
+
+// Calendar date
+typedef struct {
+  uint16_t year;                    // 1970 .. 2105
+  uint8_t  month;                   // 1 .. 12
+  uint8_t  day;                     // 1 .. 31
+  uint8_t  hour;                    // 0 .. 23
+  uint8_t  minute;                  // 0 .. 59
+  uint8_t  second;                  // 0 .. 59
+  uint8_t  weekday;                 // 0 (Sunday) .. 6 (Saturday)
+} TIME_date_t;
+
+// TIME functions
+void TIME_init(void);                                   // init RTC and alarms
+void TIME_set(uint32_t seconds);                        // set seconds since epoch
+uint32_t TIME_seconds(void);                            // get seconds since epoch
+void TIME_get(TIME_stamp_t* stamp);                     // get timestamp
+void TIME_toDate(uint32_t seconds, TIME_date_t* date);  // seconds -> calendar
+uint32_t TIME_fromDate(const TIME_date_t* date);        // calendar -> seconds
+#define TIME_subToMs(n)   (((uint32_t)(n) * 1000) / (TIME_RTC_PRL + 1))
+
+// TIME alarm functions
+uint8_t TIME_alarmAt(uint32_t seconds, void (*func)(void), uint32_t period);
+uint8_t TIME_alarmCancel(uint8_t id);
+uint8_t TIME_alarmCount(void);
+#define TIME_alarmIn(s, f, p)   TIME_alarmAt(TIME_seconds() + (s), f, p)
+
+#ifdef __cplusplus
+};
+#endif
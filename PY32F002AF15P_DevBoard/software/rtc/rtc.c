@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Example for PY32F002A
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,8 +10,11 @@
 //
 // Description:
 // ------------
-// Blink built-in LED using RTC interrupts. By the way, officially the PY32F002A has 
-// no RTC.
+// Timekeeping with the RTC. By the way, officially the PY32F002A has no RTC. Several
+// alarms are served by the single RTC alarm: the built-in LED is toggled every second,
+// a report with date, time and sub-second timestamp is sent via serial DEBUG every
+// ten seconds, and a one-shot alarm cancels the report after one minute. In between,
+// the device is put into STOP mode and woken up by the RTC alarm.
 //
 // Compilation Instructions:
 // -------------------------
@@ -19,7 +22,7 @@
 //   installed. If necessary, a driver for the USB-to-serial converter used must
 //   be installed.
 // - Connect your MCU board via USB to your PC.
-// - Set the MCU to boot mode by holding down the BOOT key and then pressing and 
+// - Set the MCU to boot mode by holding down the BOOT key and then pressing and
 //   releasing the RESET key. Finally release the BOOT key.
 // - Run 'make flash'.
 
@@ -29,28 +32,87 @@
 // ===================================================================================
 #include "system.h"               // system functions
 #include "gpio.h"                 // GPIO functions
+#include "debug.h"                // serial debug functions
+#include "rtctime.h"              // RTC timekeeping functions
 
 #define PIN_LED   PB0             // define LED pin
 
+volatile uint8_t reportFlag = 0;  // report requested by alarm
+uint8_t reportID;                 // id of report alarm
+
 // ===================================================================================
-// RTC Interrupt Service Routine
+// Alarm Functions (called by RTC interrupt)
 // ===================================================================================
-void RTC_IRQHandler(void) __attribute__((interrupt));
-void RTC_IRQHandler(void) {
-  RTC->CRL = 0;                   // clear interrupt flags
+
+// Toggle LED
+void BLINK_alarm(void) {
   PIN_toggle(PIN_LED);            // toggle LED on/off
 }
 
+// Request report
+void REPORT_alarm(void) {
+  reportFlag = 1;                 // report is sent by main loop
+}
+
+// Stop reports
+void STOP_alarm(void) {
+  TIME_alarmCancel(reportID);     // cancel report alarm
+  reportFlag = 2;                 // send final message
+}
+
+// ===================================================================================
+// Print Functions
+// ===================================================================================
+
+// Print value with two digits
+void PRINT_2(uint8_t value) {
+  DEBUG_write('0' + value / 10);
+  DEBUG_write('0' + value % 10);
+}
+
+// Print date, time and milliseconds of timestamp
+void PRINT_stamp(TIME_stamp_t* stamp) {
+  TIME_date_t date;
+  uint16_t ms = TIME_subToMs(stamp->sub);
+  TIME_toDate(stamp->seconds, &date);
+  DEBUG_printD(date.year); DEBUG_write('-');
+  PRINT_2(date.month);     DEBUG_write('-');
+  PRINT_2(date.day);       DEBUG_write(' ');
+  PRINT_2(date.hour);      DEBUG_write(':');
+  PRINT_2(date.minute);    DEBUG_write(':');
+  PRINT_2(date.second);    DEBUG_write('.');
+  PRINT_2(ms / 10);        DEBUG_write('0' + ms % 10);
+  DEBUG_newline();
+}
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
   // Setup
+  TIME_date_t start = {2023, 6, 1, 12, 0, 0, 0};
+  TIME_stamp_t stamp;
   PIN_output(PIN_LED);            // set LED pin as output
-  RTC_init();                     // init RTC
-  RTC->CRH = RTC_CRH_SECIE;       // enable second interrupt
-  NVIC_EnableIRQ(RTC_IRQn);       // enable RTC interrupt
+  DEBUG_init();                   // init DEBUG (TX: PA2, BAUD: 115200, 8N1)
+  TIME_init();                    // init RTC and alarm queue
+  TIME_set(TIME_fromDate(&start));// set date and time
+
+  // Setup alarms
+  TIME_alarmIn(1, BLINK_alarm, 1);                  // every second
+  reportID = TIME_alarmIn(10, REPORT_alarm, 10);    // every ten seconds
+  TIME_alarmIn(60, STOP_alarm, 0);                  // once after one minute
+  TIME_get(&stamp);
+  DEBUG_print("Start: "); PRINT_stamp(&stamp);
 
   // Loop
-  while(1);                       // handled by interrupt
+  while(1) {
+    if(reportFlag) {
+      TIME_get(&stamp);           // timestamp of wake-up
+      DEBUG_print(reportFlag == 1 ? "Alarm: " : "Stop:  ");
+      PRINT_stamp(&stamp);
+      reportFlag = 0;
+      while(!(USART1->SR & USART_SR_TC));           // wait for UART to finish
+    }
+    STOP_WFI_now();               // STOP until next alarm
+  }
 }
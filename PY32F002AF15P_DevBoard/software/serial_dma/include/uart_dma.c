@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART1 with DMA RX Buffer for PY32F0xx                                      * v1.0 *
+// UART1 with DMA RX Buffer for PY32F0xx                                      * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -7,7 +7,7 @@
 
 // Circular RX buffer
 char UART_RX_buffer[UART_RX_BUF_SIZE];
-uint8_t UART_RX_tptr = 0;
+uint16_t UART_RX_tptr = 0;
 #define UART_RX_hptr (UART_RX_BUF_SIZE - UART_DMA_CHAN->CNDTR)
 
 // Init UART
@@ -127,6 +127,36 @@ char UART_read(void) {
   return result;
 }
 
+// Get next character from UART buffer without removing it
+char UART_peek(void) {
+  while(!UART_available());
+  return UART_RX_buffer[UART_RX_tptr];
+}
+
+// Get the one or two contiguous filled regions of the RX buffer, return byte count
+uint16_t UART_rxSpans(UART_SPAN_t* span) {
+  uint16_t head = UART_RX_hptr;
+  uint16_t tail = UART_RX_tptr;
+  span->data1 = &UART_RX_buffer[tail];
+  span->data2 = UART_RX_buffer;
+  if(head >= tail) {
+    span->len1 = head - tail;
+    span->len2 = 0;
+  }
+  else {
+    span->len1 = UART_RX_BUF_SIZE - tail;
+    span->len2 = head;
+  }
+  return(span->len1 + span->len2);
+}
+
+// Remove n bytes from RX buffer (n must not exceed count returned by UART_rxSpans)
+void UART_consume(uint16_t n) {
+  uint16_t tail = UART_RX_tptr + n;
+  if(tail >= UART_RX_BUF_SIZE) tail -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = tail;
+}
+
 // Send byte via UART
 void UART_write(const char c) {
   while(!UART_ready());
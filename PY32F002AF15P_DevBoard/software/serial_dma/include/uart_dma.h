@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART1 with DMA RX Buffer for PY32F0xx                                      * v1.0 *
+// UART1 with DMA RX Buffer for PY32F0xx                                      * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -17,6 +17,9 @@
 // UART_completed()         Check if transmission is completed
 //
 // UART_read()              Read character via UART
+// UART_peek()              Get next character without removing it from RX buffer
+// UART_rxSpans(s)          Get filled regions of RX buffer (zero-copy), returns count
+// UART_consume(n)          Remove n bytes from RX buffer (after UART_rxSpans)
 // UART_write(c)            Send character via UART
 //
 // UART_enable()            Enable USART
@@ -54,7 +57,7 @@ extern "C" {
 
 // UART parameters
 #define UART_BAUD             115200    // default UART baud rate
-#define UART_RX_BUF_SIZE      64        // UART RX buffer size
+#define UART_RX_BUF_SIZE      64        // UART RX buffer size (max 65535)
 #define UART_MAP              0         // UART pin mapping (see above)
 #define UART_DMA_CHANNEL      1         // DMA channel (1 - 3)
 #define UART_PRINT            0         // 1 = include print functions (needs print.h)
@@ -77,9 +80,20 @@ extern "C" {
 #define UART_setOddParity()   {USART1->CR1 |= USART_CR1_PCE; USART1->CR1 |=  USART_CR1_PS;}
 #define UART_setNoParity()    USART1->CR1 &= ~USART_CR1_PCE
 
+// UART RX span, one or two contiguous filled regions of the circular RX buffer
+typedef struct {
+  char*    data1;                                 // first region (oldest bytes)
+  uint16_t len1;                                  // length of first region
+  char*    data2;                                 // second region (wrapped around)
+  uint16_t len2;                                  // length of second region
+} UART_SPAN_t;
+
 // UART functions
 void UART_init(void);                             // init UART with default BAUD rate
 char UART_read(void);                             // read character via UART
+char UART_peek(void);                             // get next char without removing it
+uint16_t UART_rxSpans(UART_SPAN_t* span);         // get filled regions of RX buffer
+void UART_consume(uint16_t n);                    // remove n bytes from RX buffer
 void UART_write(const char c);                    // send character via UART
 uint8_t UART_available(void);                     // check if there is something to read
 
@@ -0,0 +1,146 @@
+// ===================================================================================
+// Tickless Low-Power Job Scheduler with LPT Wake-Up for PY32F0xx             * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "sched.h"
+
+#define SCHED_ARR_MAX     0xFFFF                        // max LPT period in ticks
+#define SCHED_MIN_GAP     2                             // min ticks left to sleep
+
+// Job table
+typedef struct {
+  void (*func)(void);                                   // job function (0: unused)
+  uint32_t next;                                        // next deadline in ticks
+  uint16_t period;                                      // period in ms
+  uint16_t frac;                                        // remainder of ticks * 1000
+} SCHED_job_t;
+
+static SCHED_job_t SCHED_job[SCHED_JOBS];
+
+// Scheduler state (.bss is not cleared by startup code, see SCHED_init)
+static uint32_t SCHED_base;                             // time of last LPT start
+uint8_t  SCHED_stopAllowed;                             // 1: STOP mode allowed
+uint32_t SCHED_wakeups;                                 // number of wake-ups
+uint32_t SCHED_stops;                                   // wake-ups from STOP mode
+
+// Read LPT counter (runs asynchronously to system clock, so read until stable)
+static uint16_t SCHED_count(void) {
+  uint16_t cnt;
+  do cnt = LPTIM->CNT; while(cnt != LPTIM->CNT);
+  return cnt;
+}
+
+// Start LPT single shot with max period, counter measures time since then
+static void SCHED_start(void) {
+  DLY_ms(2);                                            // wait two LPT clock cycles
+  LPTIM->ARR = SCHED_ARR_MAX;                           // set max period
+  LPTIM->CR |= LPTIM_CR_SNGSTRT;                        // start timer in single mode
+}
+
+// Advance deadline of job by one period, keep remainder of ms to ticks conversion
+static void SCHED_advance(SCHED_job_t* job) {
+  uint32_t num = (uint32_t)job->period * SCHED_TICK_HZ + job->frac;
+  job->next += num / 1000;
+  job->frac  = num % 1000;
+}
+
+// Init scheduler and low-power timer
+void SCHED_init(void) {
+  uint8_t i;
+  for(i = 0; i < SCHED_JOBS; i++) SCHED_job[i].func = 0;
+  SCHED_base        = 0;
+  SCHED_wakeups     = 0;
+  SCHED_stops       = 0;
+  SCHED_stopAllowed = 1;
+  LPT_init();                                           // init low-power timer
+  #if SCHED_LOW_POWER == 1
+  STOP_lowPower();                                      // reduce power in STOP mode
+  #endif
+  SCHED_start();
+}
+
+// Get scheduler time in LPT ticks
+uint32_t SCHED_now(void) {
+  return SCHED_base + SCHED_count();
+}
+
+// Add periodic job, return job id (SCHED_NONE: no free slot or invalid period)
+uint8_t SCHED_add(void (*func)(void), uint16_t ms) {
+  uint8_t i;
+  if(!func || !ms) return SCHED_NONE;
+  for(i = 0; i < SCHED_JOBS; i++) {
+    if(SCHED_job[i].func) continue;
+    SCHED_job[i].period = ms;
+    SCHED_job[i].frac   = 0;
+    SCHED_job[i].next   = SCHED_now();
+    SCHED_advance(&SCHED_job[i]);
+    SCHED_job[i].func   = func;
+    return i;
+  }
+  return SCHED_NONE;
+}
+
+// Remove job
+void SCHED_remove(uint8_t id) {
+  if(id < SCHED_JOBS) SCHED_job[id].func = 0;
+}
+
+// Run due jobs, then sleep until next deadline
+void SCHED_run(void) {
+  SCHED_job_t* job;
+  uint32_t now, next, gap;
+  uint16_t elapsed;
+  uint8_t  i, stop;
+
+  // Run jobs which are due (or due within slack time)
+  now = SCHED_now();
+  for(i = 0; i < SCHED_JOBS; i++) {
+    job = &SCHED_job[i];
+    if(!job->func || ((int32_t)(job->next - now) > SCHED_SLACK)) continue;
+    job->func();
+    SCHED_advance(job);
+    now = SCHED_now();
+    while((int32_t)(job->next - now) <= 0) SCHED_advance(job);  // skip missed periods
+  }
+
+  // Find next deadline, limit gap to LPT range
+  next = now + SCHED_ARR_MAX;
+  for(i = 0; i < SCHED_JOBS; i++) {
+    job = &SCHED_job[i];
+    if(job->func && ((int32_t)(job->next - next) < 0)) next = job->next;
+  }
+  gap = next - SCHED_base;
+  if((int32_t)gap < 0) gap = 0;
+  if(gap > SCHED_ARR_MAX) gap = SCHED_ARR_MAX;
+
+  // Not enough time left to sleep
+  elapsed = SCHED_count();
+  if((int32_t)(gap - elapsed) < SCHED_MIN_GAP) {
+    if(elapsed >= SCHED_ARR_MAX - SCHED_MIN_GAP) {      // LPT runs out: restart it
+      SCHED_base += elapsed + SCHED_WAKE_TICKS;
+      LPTIM->ICR  = LPTIM_ICR_ARRMCF;
+      SCHED_start();
+    }
+    return;
+  }
+
+  // Sleep until auto-reload match, choose STOP for long gaps
+  stop = SCHED_stopAllowed && (gap - elapsed >= SCHED_STOP_MIN);
+  LPTIM->ARR = gap;                                     // wake-up relative to LPT start
+  SCB->SCR |= SCB_SCR_SEVONPEND_Msk;                    // enable wake-up on pending int
+  if(stop) STOP_WFE_now();                              // put device into STOP
+  else     SLEEP_WFE_now();                             // put device into SLEEP
+  SCB->SCR &= ~SCB_SCR_SEVONPEND_Msk;                   // disable wake-up on pending int
+
+  // Woken up by other event: LPT still runs, deadline is checked again on next call
+  if(!(LPTIM->ISR & LPTIM_ISR_ARRM)) return;
+
+  // Woken up by LPT: add period and wake-up time, restart LPT
+  SCHED_wakeups++;
+  if(stop) SCHED_stops++;
+  SCHED_base += gap + SCHED_WAKE_TICKS;
+  LPTIM->ICR  = LPTIM_ICR_ARRMCF;                       // clear LPT interrupt flag
+  NVIC_ClearPendingIRQ(LPTIM1_IRQn);                    // clear NVIC pending flag
+  SCHED_start();
+}
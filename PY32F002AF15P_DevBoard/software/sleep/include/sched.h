@@ -0,0 +1,70 @@
+// ===================================================================================
+// Tickless Low-Power Job Scheduler with LPT Wake-Up for PY32F0xx             * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// SCHED_init()             Init scheduler and low-power timer (LPT)
+// SCHED_add(f, ms)         Add periodic job function (f) with period in ms (1..65535),
+//                          first call after one period, return job id (SCHED_NONE: full)
+// SCHED_remove(id)         Remove job with id
+// SCHED_run()              Run due jobs, then sleep until the next deadline (call this
+//                          in the main loop)
+// SCHED_now()              Get scheduler time in LPT ticks (1/1024s)
+// SCHED_allowStop(b)       Allow (1) or forbid (0) STOP mode (e.g. while UART is busy)
+//
+// SCHED_wakeups            Number of wake-ups (for statistics)
+// SCHED_stops              Number of wake-ups from STOP mode (for statistics)
+//
+// The scheduler does not use a periodic tick. The LPT (LSI / 32 = 1024Hz) runs as a
+// single shot which is started on every wake-up. While the jobs are executed, the LPT
+// counter measures the time since the wake-up. Before going to sleep, the next
+// deadline of all jobs is written into the auto-reload register relative to that
+// wake-up, so the run time of the jobs does not add any drift. Jobs which are due
+// within SCHED_SLACK ticks are executed together in order to save wake-ups. Job
+// periods are converted from ms to LPT ticks with a fractional remainder for each
+// job, so the LPT granularity of ~0.98ms does not accumulate either. The time between
+// the auto-reload match and the restart of the LPT (wake-up time of the MCU plus the
+// LPT synchronization) is not measured and added as SCHED_WAKE_TICKS.
+//
+// If the gap to the next deadline is at least SCHED_STOP_MIN ticks, the device is
+// put into STOP mode (with STOP_lowPower() if SCHED_LOW_POWER is set), otherwise into
+// SLEEP mode, since waking up from STOP takes longer and costs more energy than a
+// short SLEEP. Gaps longer than the 16-bit LPT range are split into several sleeps.
+// The LPT must not be used by other code.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// SCHED parameters
+#define SCHED_JOBS        4         // max number of jobs
+#define SCHED_TICK_HZ     1024      // LPT clock frequency (LSI 32768Hz / prescaler 32)
+#define SCHED_SLACK       2         // run jobs due within this number of ticks early
+#define SCHED_STOP_MIN    8         // min gap in ticks to use STOP instead of SLEEP
+#define SCHED_WAKE_TICKS  2         // ticks between wake-up and restart of LPT
+#define SCHED_LOW_POWER   1         // 1: use STOP_lowPower() in STOP mode
+
+// SCHED functions
+void SCHED_init(void);                                  // init scheduler and LPT
+uint8_t SCHED_add(void (*func)(void), uint16_t ms);     // add periodic job
+void SCHED_remove(uint8_t id);                          // remove job
+void SCHED_run(void);                                   // run due jobs and sleep
+uint32_t SCHED_now(void);                               // time in LPT ticks
+
+// SCHED variables and macros
+extern uint8_t  SCHED_stopAllowed;                      // 1: STOP mode allowed
+extern uint32_t SCHED_wakeups;                          // number of wake-ups
+extern uint32_t SCHED_stops;                            // wake-ups from STOP mode
+#define SCHED_allowStop(b)  SCHED_stopAllowed = (b)     // allow/forbid STOP mode
+#define SCHED_NONE          0xFF                        // no job
+
+#ifdef __cplusplus
+};
+#endif
@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Example for PY32F002A
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,7 +10,11 @@
 //
 // Description:
 // ------------
-// Blink built-in LED using deep sleep with LPTIM as wake-up timer.
+// Blink built-in LED using deep sleep with LPTIM as wake-up timer. Two periodic jobs
+// are served by the tickless scheduler: the LED is toggled every 500ms and flashes
+// twice every 3000ms. In between, the device sleeps in STOP (or SLEEP for short gaps)
+// until the next deadline, the deadlines of both jobs coincide every 3000ms and are
+// served by one wake-up.
 //
 // Compilation Instructions:
 // -------------------------
@@ -28,20 +32,40 @@
 // ===================================================================================
 #include "system.h"               // system functions
 #include "gpio.h"                 // GPIO functions
+#include "sched.h"                // scheduler functions
 
 #define PIN_LED   PB0             // define LED pin
 
+// ===================================================================================
+// Jobs
+// ===================================================================================
+
+// Toggle LED
+void BLINK_job(void) {
+  PIN_toggle(PIN_LED);            // toggle LED on/off
+}
+
+// Flash LED twice (run time does not shift the deadlines)
+void FLASH_job(void) {
+  uint8_t i;
+  for(i = 4; i; i--) {
+    PIN_toggle(PIN_LED);          // toggle LED on/off
+    DLY_ms(50);                   // wait a moment
+  }
+}
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
   // Setup
   PIN_output(PIN_LED);            // set LED pin as output
-  LPT_init();                     // init low-power timer
+  SCHED_init();                   // init scheduler and low-power timer
+  SCHED_add(BLINK_job,  500);     // toggle LED every 500ms
+  SCHED_add(FLASH_job, 3000);     // flash LED every 3000ms
 
   // Loop
   while(1) {
-    PIN_toggle(PIN_LED);          // toggle LED on/off
-    LPT_stop(100);                // set device into STOP (deep sleep) for 100ms
+    SCHED_run();                  // run due jobs, sleep until next deadline
   }
 }
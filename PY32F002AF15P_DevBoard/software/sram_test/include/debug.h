@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for PY32F0xx                                  * v1.0 *
+// Basic Serial Debug Functions for PY32F0xx                                  * v1.1 *
 // ===================================================================================
 //
 // Functions available:
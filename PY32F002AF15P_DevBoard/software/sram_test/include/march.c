@@ -0,0 +1,139 @@
+// ===================================================================================
+// Word-Wide March-C SRAM Self-Test for PY32F0xx                              * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "march.h"
+
+#if (MARCH_PATTERNS < 1) || (MARCH_PATTERNS > 6)
+  #error MARCH_PATTERNS must be 1 - 6
+#endif
+
+// RAM boundaries from linker script
+extern uint32_t _ebss;
+extern uint32_t _estack;
+
+// Data backgrounds: each pair of bits within a word differs in at least one of them
+static const uint32_t MARCH_pattern[] = {
+  0x00000000, 0x55555555, 0x33333333, 0x0F0F0F0F, 0x00FF00FF, 0x0000FFFF
+};
+
+// Test state and results
+uint32_t MARCH_pos;                                     // next slice address
+uint32_t MARCH_faults;                                  // number of faults
+uint32_t MARCH_faultAddr;                               // address of first fault
+uint32_t MARCH_faultBits;                               // flipped bits of first fault
+uint32_t MARCH_passes;                                  // completed passes
+
+// Reset test position and fault counters (.bss is not cleared by startup code)
+void MARCH_init(void) {
+  MARCH_pos       = MARCH_RAM_START;
+  MARCH_faults    = 0;
+  MARCH_faultAddr = 0;
+  MARCH_faultBits = 0;
+  MARCH_passes    = 0;
+}
+
+// Faults found by one test run (kept on the stack, the slice may hold the globals)
+typedef struct {
+  uint32_t count;                                       // number of faults
+  uint32_t addr;                                        // address of first fault
+  uint32_t bits;                                        // flipped bits of first fault
+} MARCH_result_t;
+
+// Read word and compare with expected value
+#define MARCH_check(p, v) {uint32_t r = *(p); if(r != (v)) MARCH_fault(res, p, v ^ r);}
+
+// Record fault of test run
+static void MARCH_fault(MARCH_result_t* res, volatile uint32_t* addr, uint32_t bits) {
+  if(!res->count++) {
+    res->addr = (uint32_t)addr;
+    res->bits = bits;
+  }
+}
+
+// Add faults of test run to results
+static void MARCH_record(MARCH_result_t* res) {
+  if(!res->count) return;
+  if(!MARCH_faults) {
+    MARCH_faultAddr = res->addr;
+    MARCH_faultBits = res->bits;
+  }
+  MARCH_faults += res->count;
+}
+
+// Run March C- with all data backgrounds on n words starting at p
+static void MARCH_run(MARCH_result_t* res, volatile uint32_t* p, uint32_t n) {
+  volatile uint32_t* q;
+  volatile uint32_t* end = p + n;
+  uint32_t b, i;
+  res->count = 0;
+  for(i = 0; i < MARCH_PATTERNS; i++) {
+    b = MARCH_pattern[i];
+    for(q = p; q < end; q++)   *q = b;                  // up(w0)
+    for(q = p; q < end; q++) { MARCH_check(q,  b); *q = ~b; }  // up(r0,w1)
+    for(q = p; q < end; q++) { MARCH_check(q, ~b); *q =  b; }  // up(r1,w0)
+    for(q = end; q-- > p;)   { MARCH_check(q,  b); *q = ~b; }  // down(r0,w1)
+    for(q = end; q-- > p;)   { MARCH_check(q, ~b); *q =  b; }  // down(r1,w0)
+    for(q = p; q < end; q++)   MARCH_check(q,  b);      // up(r0)
+  }
+}
+
+// Destructive test of SRAM from start to end, return bytes tested
+uint32_t MARCH_testRange(uint32_t start, uint32_t end) {
+  MARCH_result_t res;
+  start = (start + 3) & ~3;
+  end  &= ~3;
+  if(end <= start) return 0;
+  MARCH_run(&res, (volatile uint32_t*)start, (end - start) >> 2);
+  MARCH_record(&res);
+  return end - start;
+}
+
+// Destructive test of SRAM not used by the firmware, return bytes tested
+uint32_t MARCH_testFree(void) {
+  uint32_t bytes = MARCH_testRange((uint32_t)&_ebss, __get_MSP() - MARCH_GUARD);
+  if((uint32_t)&_estack < MARCH_RAM_END)                // SRAM beyond linker script
+    bytes += MARCH_testRange((uint32_t)&_estack, MARCH_RAM_END);
+  return bytes;
+}
+
+// Non-destructive test of next slice with interrupts masked, return bytes tested
+uint32_t MARCH_step(void) {
+  uint32_t save[MARCH_SLICE];
+  MARCH_result_t res;
+  volatile uint32_t* p = (volatile uint32_t*)MARCH_pos;
+  uint32_t n = (MARCH_RAM_END - MARCH_pos) >> 2;
+  uint32_t sp, primask, i;
+
+  // Advance position, count completed passes
+  if(n > MARCH_SLICE) n = MARCH_SLICE;
+  MARCH_pos += n << 2;
+  if(MARCH_pos >= MARCH_RAM_END) {
+    MARCH_pos = MARCH_RAM_START;
+    MARCH_passes++;
+  }
+
+  // Skip slice holding the current stack frame
+  sp = __get_MSP();
+  if(((uint32_t)(p + n) > sp - MARCH_GUARD) && ((uint32_t)p < sp + sizeof(save) + MARCH_GUARD))
+    return 0;
+
+  // Save slice, test it and restore it with interrupts masked
+  primask = __get_PRIMASK();
+  __disable_irq();
+  for(i = 0; i < n; i++) save[i] = p[i];
+  MARCH_run(&res, p, n);
+  for(i = 0; i < n; i++) p[i] = save[i];
+  __set_PRIMASK(primask);
+  MARCH_record(&res);
+  return n << 2;
+}
+
+// Run background test until whole SRAM was tested once, return bytes tested
+uint32_t MARCH_cycle(void) {
+  uint32_t bytes  = 0;
+  uint32_t passes = MARCH_passes;
+  while(MARCH_passes == passes) bytes += MARCH_step();
+  return bytes;
+}
@@ -0,0 +1,71 @@
+// ===================================================================================
+// Word-Wide March-C SRAM Self-Test for PY32F0xx                              * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// MARCH_init()             Reset test position and fault counters
+// MARCH_testFree()         Destructive test of unused SRAM (between end of .bss and
+//                          stack, and above the linker's RAM end), return bytes tested
+// MARCH_testRange(s,e)     Destructive test of SRAM from address s to e (word aligned)
+// MARCH_step()             Non-destructive test of next slice of SRAM with interrupts
+//                          masked, return bytes tested (0: slice skipped)
+// MARCH_cycle()            Run MARCH_step() until whole SRAM was tested once
+//
+// MARCH_faults             Number of detected faults (faulty word reads)
+// MARCH_faultAddr          Address of first detected fault (0: none)
+// MARCH_faultBits          Flipped bits of first detected fault
+// MARCH_passes             Number of completed background passes over whole SRAM
+//
+// The March C- algorithm is used on 32-bit words:
+//   up(w0); up(r0,w1); up(r1,w0); down(r0,w1); down(r1,w0); up(r0)
+// It detects stuck-at, transition, address decoder and inter-word coupling faults
+// with 10 accesses per word. Since a word is accessed as a whole, the test is repeated
+// with MARCH_PATTERNS data backgrounds (0x00000000, 0x55555555, 0x33333333, ...)
+// instead of 0 for the bits within the word, which also covers intra-word coupling.
+//
+// MARCH_testFree() is meant as a fast power-on self-test. It only destroys SRAM which
+// is not used by the firmware. MARCH_step() saves a slice of MARCH_SLICE words on the
+// stack, tests it with interrupts masked, restores it and advances to the next slice,
+// so it can be called from the main loop of a running application. Coupling faults
+// between different slices are not detected by the background test. The slice which
+// holds the stack frame of MARCH_step() itself (MARCH_GUARD bytes around the stack
+// pointer) is skipped. Interrupts are masked for MARCH_SLICE * 10 * MARCH_PATTERNS
+// word accesses per call.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// MARCH parameters
+#define MARCH_RAM_SIZE    3072        // SRAM size in bytes to be tested
+#define MARCH_SLICE       16          // words per background slice (MARCH_step)
+#define MARCH_PATTERNS    6           // number of data backgrounds (1 - 6)
+#define MARCH_GUARD       64          // bytes around stack pointer to skip
+
+// MARCH functions
+void MARCH_init(void);                                  // reset position and faults
+uint32_t MARCH_testRange(uint32_t start, uint32_t end); // destructive test of range
+uint32_t MARCH_testFree(void);                          // destructive test unused RAM
+uint32_t MARCH_step(void);                              // test next slice
+uint32_t MARCH_cycle(void);                             // test whole RAM once
+
+// MARCH results
+extern uint32_t MARCH_faults;                           // number of faults
+extern uint32_t MARCH_faultAddr;                        // address of first fault
+extern uint32_t MARCH_faultBits;                        // flipped bits of first fault
+extern uint32_t MARCH_passes;                           // completed background passes
+
+// MARCH defines
+#define MARCH_RAM_START   SRAM_BASE
+#define MARCH_RAM_END     (SRAM_BASE + MARCH_RAM_SIZE)
+
+#ifdef __cplusplus
+};
+#endif
@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Example for PY32F002A
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,8 +10,16 @@
 //
 // Description:
 // ------------
-// Find out the real size of chip's SRAM. Chip will hang if trying to write to invalid
-// SRAM address. I bet the PY32F002A actually has 4KB SRAM.
+// SRAM self-test with a word-wide March C- algorithm. At power-on, the SRAM which is
+// not used by the firmware is tested destructively, followed by one non-destructive
+// pass over the whole SRAM. Afterwards, the main loop tests one slice of SRAM per
+// iteration in the background (interrupts are only masked while a slice is tested),
+// like it would be done in a long-running application. The test speed in bytes per
+// second, the longest time with interrupts masked and the detected faults are
+// reported via serial DEBUG.
+//
+// Set MARCH_RAM_SIZE in march.h to 4096 to include the upper KB of SRAM, which the
+// PY32F002A seems to have but which is not documented.
 //
 // Compilation Instructions:
 // -------------------------
@@ -19,7 +27,7 @@
 //   installed. If necessary, a driver for the USB-to-serial converter used must
 //   be installed.
 // - Connect your MCU board via USB to your PC.
-// - Set the MCU to boot mode by holding down the BOOT key and then pressing and 
+// - Set the MCU to boot mode by holding down the BOOT key and then pressing and
 //   releasing the RESET key. Finally release the BOOT key.
 // - Run 'make flash'.
 
@@ -29,26 +37,64 @@
 // ===================================================================================
 #include "system.h"                         // system functions
 #include "debug.h"                          // serial debug functions
+#include "march.h"                          // March-C SRAM test functions
+
+#define REPORT_PASSES     100               // background passes between reports
+
+// Benchmark timer (SysTick down-counter, max 0.7s at 24MHz)
+#define BENCH_start()     {SysTick->LOAD = 0xFFFFFF; SysTick->VAL = 0;}
+#define BENCH_ticks()     ((0xFFFFFF - SysTick->VAL) & 0xFFFFFF)
+
+// ===================================================================================
+// Report Function
+// ===================================================================================
+void REPORT(char* name, uint32_t bytes, uint32_t ticks) {
+  DEBUG_print(name);
+  DEBUG_printD(bytes); DEBUG_print(" bytes in ");
+  DEBUG_printD(ticks / (F_CPU / 1000000)); DEBUG_print("us (");
+  DEBUG_printD(ticks ? (uint32_t)((uint64_t)bytes * F_CPU / ticks) : 0);
+  DEBUG_print(" bytes/s), faults: ");
+  DEBUG_printD(MARCH_faults);
+  if(MARCH_faults) {
+    DEBUG_print(", first at 0x"); DEBUG_printW(MARCH_faultAddr);
+    DEBUG_print(", bits 0x");     DEBUG_printW(MARCH_faultBits);
+  }
+  DEBUG_newline();
+}
 
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main (void) {
   // Setup
-  uint32_t addr;                            // SRAM address
-  IWDG_start(1000);                         // start watchdog timer with 1000ms
+  uint32_t bytes, ticks, maxticks, t;       // test statistics
+  MARCH_init();                             // reset test state
+
+  // Power-on self-test
+  BENCH_start();
+  bytes = MARCH_testFree();                 // destructive test of unused SRAM
+  ticks = BENCH_ticks();
   DEBUG_init();                             // init DEBUG (TX: PA2, BAUD: 115200, 8N1)
-  DEBUG_println(" - failed");               // print failed after watchdog reset
+  REPORT("POST free SRAM:  ", bytes, ticks);
+  BENCH_start();
+  bytes = MARCH_cycle();                    // non-destructive test of whole SRAM
+  ticks = BENCH_ticks();
+  REPORT("POST whole SRAM: ", bytes, ticks);
 
   // Loop
+  bytes = 0; ticks = 0; maxticks = 0;
   while(1) {
-    for(uint8_t i=1; i<=32; i++) {          // i contains current KB in the test
-      addr = SRAM_BASE + (1024 * i) - 1;    // calculate last address of current KB
-      DEBUG_print("Testing address 0x");    // info
-      DEBUG_printW(addr);                   // print SRAM address to be tested
-      *(uint8_t*)addr = 0x00;               // write to SRAM address, hangs if invalid
-      DEBUG_print(" - passed ");            // ok, it hasn't failed yet
-      DEBUG_printD(i); DEBUG_println("KB"); // print SRAM size tested
+    BENCH_start();
+    bytes += MARCH_step();                  // test one slice per iteration
+    t = BENCH_ticks();
+    ticks += t;
+    if(t > maxticks) maxticks = t;          // time with interrupts masked (approx.)
+    if(MARCH_passes >= REPORT_PASSES) {
+      REPORT("Background:      ", bytes, ticks);
+      DEBUG_print("Max IRQs masked: ");
+      DEBUG_printD(maxticks / (F_CPU / 1000000)); DEBUG_println("us");
+      MARCH_passes = 0;
+      bytes = 0; ticks = 0; maxticks = 0;
     }
   }
 }